@@ -3,7 +3,36 @@
 #define debug(input)   { if (_serial) _serial->print(input);   }
 #define debugln(input) { if (_serial) _serial->println(input); }
 
-#if defined( __AVR_ATtiny84__ )
+#if NRFLITE_STATS
+    #define stats(statement) { statement; }
+#else
+    #define stats(statement)
+#endif
+
+#if NRFLITE_TRACE
+    #define trace(type, value) addTraceEvent(type, value)
+#else
+    #define trace(type, value)
+#endif
+
+// Trace event types, see 'printTrace'.  extras/decode_trace.py uses the same numbers.
+const static uint8_t TRACE_CE       = 1; // Value = pin level.
+const static uint8_t TRACE_SPI      = 2; // Value = SPI command.
+const static uint8_t TRACE_STATUS   = 3; // Value = STATUS register, recorded when its interrupt flags change.
+const static uint8_t TRACE_CONFIG   = 4; // Value = CONFIG register, recorded when it is written, showing mode changes.
+const static uint8_t TRACE_WAIT     = 5; // Value = wait time in 16 uS units rounded up, recorded when the wait starts.
+const static uint8_t TRACE_THROTTLE = 6; // 'hasData' returned without checking the radio, due to CE and CSN sharing a pin.
+
+// Bit in '_registerCacheFlags' indicating '_txRadioId' and '_txPipe' match the TX_ADDR and RX_ADDR_P0 registers.
+// Bits 0 through 6 are used for the registers having the same number.
+const static uint8_t CACHED_TX_ADDR = 7;
+
+// Powered Off mode to Standby-I mode transition time.
+const static uint16_t POWER_UP_MICROS = 1500;
+
+#if defined( NRFLITE_EXTERNAL_TRANSPORT )
+    // SPI and pin access is provided by the program, see NRFLite.h.
+#elif defined( __AVR_ATtiny84__ )
     const static uint8_t USI_DI = PA6;
     const static uint8_t USI_DO = PA5;
     const static uint8_t SCK    = PA4;
@@ -15,35 +44,49 @@
     #include <SPI.h> // Use the normal Arduino hardware SPI library if we are not on ATtiny.
 #endif
 
+uint8_t NRFLite::_spiUsesInterrupts = 0;
+
 ////////////////////
 // Public methods //
 ////////////////////
 
-uint8_t NRFLite::init(uint8_t radioId, uint8_t cePin, uint8_t csnPin, Bitrates bitrate, uint8_t channel)
+uint8_t NRFLite::init(uint8_t radioId, uint8_t cePin, uint8_t csnPin, Bitrates bitrate, uint8_t channel,
+                      uint8_t addressWidth, uint8_t crcLength, uint32_t addressPrefix)
 {
+    // Settings the radio does not support would leave it unable to talk to anything.
+    if (addressWidth < 3 || addressWidth > 5 || crcLength < 1 || crcLength > 2) { return 0; }
+    
     delay(100); // 100 ms = Vcc > 1.9v power on reset time.
     
     _cePin = cePin;
     _csnPin = csnPin;
     _enableInterruptFlagsReset = 1;
+    _registerCacheFlags = 0;
+    _rxPipe = 1;
+    stats(resetStats());
+    #if NRFLITE_TRACE
+    _traceNextEvent = 0;
+    _traceIsFull = 0;
+    _traceStatusFlags = 0;
+    #endif
+    _isPoweringUp = 0;
     
-    // Setup the microcontroller for SPI communication with the radio.
-    #if defined(__AVR_ATtiny84__) || defined(__AVR_ATtiny85__)
-    pinMode(USI_DI, INPUT ); digitalWrite(USI_DI, HIGH);
-    pinMode(USI_DO, OUTPUT); digitalWrite(USI_DO, LOW);
-    pinMode(SCK, OUTPUT); digitalWrite(SCK, LOW);
-    #else
-    // Arduino SPI makes SS (D10) an output and sets it HIGH.  It must remain an output
-    // for Master SPI operation to work, but in case it was originally LOW, we'll set it back.
-    uint8_t savedSS = digitalRead(SS);
-    SPI.setClockDivider(SPI_CLOCK_DIV2);
-    SPI.begin();
-    if (_csnPin != SS) digitalWrite(SS, savedSS);
+    // CSN changes twice for every SPI transaction and CE is pulsed for every transmission.  digitalWrite looks up the
+    // port and bit of the pin in program memory each time it is called, taking several microseconds on a 16 MHz AVR,
+    // so we look them up once here and write the port registers directly.
+    #if defined(__AVR__) && !defined(NRFLITE_EXTERNAL_TRANSPORT)
+    _cePort = portOutputRegister(digitalPinToPort(_cePin));
+    _ceMask = digitalPinToBitMask(_cePin);
+    _csnPort = portOutputRegister(digitalPinToPort(_csnPin));
+    _csnMask = digitalPinToBitMask(_csnPin);
     #endif
     
+    // Setup the microcontroller for SPI communication with the radio.
+    transportBegin();
+    
     // When CSN is LOW the radio listens to SPI communication, so we operate most of the time with CSN HIGH.
-    pinMode(_cePin, OUTPUT); pinMode(_csnPin, OUTPUT);
-    digitalWrite(_csnPin, HIGH);
+    transportPinMode(_cePin, OUTPUT); transportPinMode(_csnPin, OUTPUT);
+    csnWrite(HIGH);
     
     // Valid channel range is 2400 - 2525 MHz, in 1 MHz increments.
     if (channel > 125) { channel = 125; }
@@ -55,21 +98,23 @@ uint8_t NRFLite::init(uint8_t radioId, uint8_t cePin, uint8_t csnPin, Bitrates b
     // Retry time  = SETUP_RETR upper 4 bits (0 = 250 uS, 1 = 500 us, 2 = 750 us, ... , 15 = 4000 us).
     // Retry count = SETUP_RETR lower 4 bits (0 to 15).
     // '_allowedDataCheckIntervalMicros' is used to limit how often the radio can be checked to determine if data
-    // has been received when CE and CSN share the same pin.  If we don't limit how often the radio is checked,
-    // the radio may never be given the chance to receive a packet.  More info about this in the 'hasData' method.
-    // '_allowedDataCheckIntervalMicros' was determined by maximizing the transfer bitrate between two 16 MHz ATmega328's
-    // using 32 byte payloads and sending back 32 byte ACK packets.
+    // has been received when CE and CSN share the same pin, see 'updateDataCheckInterval'.  It was determined by
+    // maximizing the transfer bitrate between two 16 MHz ATmega328's using 32 byte payloads and sending back 32 byte
+    // ACK packets.  '_shortPacketLength' is the longest average packet length for which bursts are checked more often,
+    // determined with the benchmark in extras/benchmark.  At 1 Mbps no shorter interval was faster.
 
     if (bitrate == BITRATE2MBPS) {
         writeRegister(RF_SETUP, B00001110);     // 2 Mbps, 0 dBm output power
         writeRegister(SETUP_RETR, B00011111);   // 0001 =  500 uS between retries, 1111 = 15 retries
         _allowedDataCheckIntervalMicros = 600;
+        _shortPacketLength = 7;
         _transmissionRetryWaitMicros = 250;
     }
     else if (bitrate == BITRATE1MBPS) {
         writeRegister(RF_SETUP, B00000110);     // 1 Mbps, 0 dBm output power
         writeRegister(SETUP_RETR, B00011111);   // 0001 =  500 uS between retries, 1111 = 15 retries
         _allowedDataCheckIntervalMicros = 1200;
+        _shortPacketLength = 0;
         _transmissionRetryWaitMicros = 1000;
     }
     else {
@@ -77,14 +122,40 @@ uint8_t NRFLite::init(uint8_t radioId, uint8_t cePin, uint8_t csnPin, Bitrates b
         writeRegister(SETUP_RETR, B01011111);   // 0101 = 1500 uS between retries, 1111 = 15 retries
         //writeRegister(SETUP_RETR, B01010001); // 0101 = 1500 uS between retries, 0001 = 1 retry (for testing failed transmissions)
         _allowedDataCheckIntervalMicros = 8000;
+        _shortPacketLength = 3;
         _transmissionRetryWaitMicros = 1500;
     }
     
+    // Addresses are 3 to 5 bytes.  Shorter addresses and CRCs take less time to send, while longer ones make it less
+    // likely that noise is mistaken for a packet or a damaged packet is accepted.  SETUP_AW = width - 2.
+    // '_frameMicros' is the airtime of a packet without data:  a 1 byte preamble, the address, a 9 bit packet control
+    // field, and the CRC.  '_byteMicros' is the airtime of each byte of data.
+    _byteMicros = bitrate == BITRATE2MBPS ? 4 : bitrate == BITRATE1MBPS ? 8 : 32;
+    _frameMicros = (((1 + addressWidth + crcLength) * 8 + 9) * _byteMicros + 7) / 8;
+    _addressWidth = addressWidth;
+    _addressPrefix[0] = addressPrefix;
+    _addressPrefix[1] = addressPrefix >> 8;
+    _addressPrefix[2] = addressPrefix >> 16;
+    writeRegister(SETUP_AW, addressWidth - 2);
+    
+    // With CE and CSN sharing a pin, 'hasData' starts out expecting occasional 32 byte packets, see 'updateDataCheckInterval'.
+    _rxLengthAverage = 32;
+    _rxArrivalMicros = 65535;
+    _rxPacketCount = 0;
+    _isDrainingRx = 0;
+    _lastDataCheckMicros = micros();
+    _lastRxCheckMicros = _lastDataCheckMicros;
+    stats(_rxEmptyMicros = _lastDataCheckMicros);
+    updateDataCheckInterval();
+    
     // Assign this radio's address to RX pipe 1.  When another radio sends us data, this is the address
     // it will use.  We use RX pipe 1 to store our address since the address in RX pipe 0 is reserved
-    // for use with auto-acknowledgment packets.
-    uint8_t address[5] = { 1, 2, 3, 4, radioId };
-    writeRegister(RX_ADDR_P1, &address, 5);
+    // for use with auto-acknowledgment packets.  The first byte of the address is the pipe number, which
+    // allows RX pipes 2-5 to be used in hub mode since they can only differ from RX pipe 1 by their first byte.
+    uint8_t address[5];
+    getAddress(1, radioId, address);
+    writeRegister(RX_ADDR_P1, &address, addressWidth);
+    writeRegister(EN_RXADDR, _BV(ERX_P0) | _BV(ERX_P1)); // In case hub mode was previously enabled.
     
     // Enable dynamically sized packets on the 2 RX pipes we use, 0 and 1.
     // RX pipe address 1 is used to for normal packets from radios that send us data.
@@ -99,21 +170,23 @@ uint8_t NRFLite::init(uint8_t radioId, uint8_t cePin, uint8_t csnPin, Bitrates b
     spiTransfer(WRITE_OPERATION, FLUSH_TX, NULL, 0);
     
     // Clear any interrupts.
-    uint8_t statusReg = readRegister(STATUS);
-    writeRegister(STATUS, statusReg | _BV(RX_DR) | _BV(TX_DS) | _BV(MAX_RT));
+    writeRegister(STATUS, _BV(RX_DR) | _BV(TX_DS) | _BV(MAX_RT));
     
     // Power on the radio and start listening, waiting for startup to complete.
     // 1500 uS = Powered Off mode to Standby mode transition time + 130 uS Standby to RX mode.
     uint8_t newConfigReg = _BV(PWR_UP) | _BV(PRIM_RX) | _BV(EN_CRC);
+    if (crcLength == 2) { newConfigReg |= _BV(CRCO); }
     writeRegister(CONFIG, newConfigReg);
-    digitalWrite(_cePin, HIGH);
-    delayMicroseconds(1630);
+    ceWrite(HIGH);
+    waitMicros(1630);
     
     // Return success if the update we made to the CONFIG register was successful.
+    // The remembered registers are cleared first so CONFIG is actually read back from the radio.
+    resyncRegisters();
     return readRegister(CONFIG) == newConfigReg;
 }
 
-void NRFLite::addAckData(void* data, uint8_t length, uint8_t removeExistingAcks)
+void NRFLite::addAckData(void* data, uint8_t length, uint8_t removeExistingAcks, uint8_t pipe)
 {
     // Up to 3 auto-acknowledgment packets can be enqueued in the TX FIFO buffer.  Users might want to ensure
     // the next ACK packet provided has the most up to date data (like a battery voltage level),
@@ -123,17 +196,44 @@ void NRFLite::addAckData(void* data, uint8_t length, uint8_t removeExistingAcks)
     }
     
     // Add the packet to the TX FIFO buffer for pipe 1, the pipe used to receive packets from radios that
-    // send us data.  When we receive the next transmission from a radio, we'll provide this ACK data in the
-    // auto-acknowledgment packet that goes back.
-    spiTransfer(WRITE_OPERATION, (W_ACK_PAYLOAD | 1), data, length);
+    // send us data, or the pipe specified when using hub mode.  When we receive the next transmission from a radio
+    // on that pipe, we'll provide this ACK data in the auto-acknowledgment packet that goes back.
+    spiTransfer(WRITE_OPERATION, (W_ACK_PAYLOAD | pipe), data, length);
+}
+
+void NRFLite::enableHubMode()
+{
+    // RX pipes 2-5 share all but the first byte of their address with RX pipe 1, so only that byte is written.
+    // It is the pipe number, matching the address transmitters use when sending to that pipe.
+    for (uint8_t pipe = 2; pipe <= 5; pipe++) {
+        writeRegister(RX_ADDR_P0 + pipe, pipe);
+    }
+    
+    // Enable the pipes along with their dynamically sized packets.  Auto-acknowledgment is enabled on all pipes
+    // by default.  RX pipe 0 stays reserved for auto-acknowledgment packets from radios we transmit to.
+    writeRegister(EN_RXADDR, _BV(ERX_P0) | _BV(ERX_P1) | _BV(ERX_P2) | _BV(ERX_P3) | _BV(ERX_P4) | _BV(ERX_P5));
+    writeRegister(DYNPD, _BV(DPL_P0) | _BV(DPL_P1) | _BV(DPL_P2) | _BV(DPL_P3) | _BV(DPL_P4) | _BV(DPL_P5));
+}
+
+uint8_t NRFLite::getRxPipe()
+{
+    return _rxPipe;
+}
+
+uint16_t NRFLite::getDataCheckInterval()
+{
+    return _dataCheckIntervalMicros;
 }
 
 uint8_t NRFLite::hasAckData()
 {
     // If we have a pipe 0 packet sitting at the top of the RX FIFO buffer, we have auto-acknowledgment data.
     // We receive ACK data from other radios using the pipe 0 address.
-    if (getPipeOfFirstRxFifoPacket() == 0) {
-        return getRxFifoPacketLength(); // Return the length of the data packet in the RX FIFO buffer.
+    uint8_t pipe;
+    uint8_t dataLength = getRxFifoPacketLength(pipe);
+    
+    if (pipe == 0) {
+        return dataLength; // Return the length of the data packet in the RX FIFO buffer.
     }
     else {
         return 0;
@@ -146,38 +246,73 @@ uint8_t NRFLite::hasData(uint8_t usingInterrupts)
     // If we don't limit the calling program, CE may mainly be LOW and the radio won't get a chance
     // to receive packets.  However, if the calling program is using an interrupt handler and only calling
     // hasData when the data received flag is set, we should skip this check since we know the calling program
-    // is not continually polling hasData.  So 'usingInterrupts' = 1 bypasses the logic.
-    if (_cePin == _csnPin && !usingInterrupts) {
+    // is not continually polling hasData.  So 'usingInterrupts' = 1 bypasses the logic.  A radio that is not
+    // in RX mode yet is not receiving anything to protect, so it is always switched to RX mode right away.
+    // Once a packet is found, the radio is checked again right away until the RX FIFO buffer is empty, since reading
+    // the packet has already brought CE LOW.
+    uint8_t originalConfigReg = readRegister(CONFIG);
+    uint8_t newConfigReg = originalConfigReg | _BV(PWR_UP) | _BV(PRIM_RX);
+    uint8_t isPolling = _cePin == _csnPin && !usingInterrupts;
+    
+    if (isPolling && !_isDrainingRx) {
         
-        if (micros() - _microsSinceLastDataCheck < _allowedDataCheckIntervalMicros) {
+        uint32_t elapsedMicros = micros() - _lastDataCheckMicros;
+        
+        if (originalConfigReg == newConfigReg && elapsedMicros < _dataCheckIntervalMicros) {
+            trace(TRACE_THROTTLE, 0);
+            stats(_stats.DataChecksSkipped++);
             return 0; // Prevent the calling program from forcing us to bring CE low, making the radio stop receiving.
         }
-        else {
-            _microsSinceLastDataCheck = micros();
+        
+        // Average the time between packets over the checks that found them.  A check that found none only raises the
+        // average, once the time since the last packet is longer, so frequent checks of an idle radio do not look like
+        // a burst.
+        _lastDataCheckMicros += elapsedMicros;
+        uint32_t gapMicros = _lastDataCheckMicros - _lastRxCheckMicros;
+        
+        if (_rxPacketCount > 0) {
+            uint32_t arrivalMicros = gapMicros / _rxPacketCount;
+            if (arrivalMicros > 65535) { arrivalMicros = 65535; }
+            _rxArrivalMicros = (_rxArrivalMicros * 3UL + arrivalMicros) / 4;
+            _rxPacketCount = 0;
+            _lastRxCheckMicros = _lastDataCheckMicros;
+        }
+        else if (gapMicros > _rxArrivalMicros) {
+            _rxArrivalMicros = gapMicros > 65535 ? 65535 : gapMicros;
         }
+        updateDataCheckInterval();
     }
     
     // Ensure radio is powered on and in RX mode in case the radio was powered down or in TX mode.
-    uint8_t originalConfigReg = readRegister(CONFIG);
-    uint8_t newConfigReg = originalConfigReg | _BV(PWR_UP) | _BV(PRIM_RX);
     if (originalConfigReg != newConfigReg) { writeRegister(CONFIG, newConfigReg); }
     
     // Ensure we're listening for packets by setting CE HIGH.  If we share the same pin for CE and CSN,
     // it will already be HIGH since we always keep CSN HIGH to prevent the radio from listening to the SPI bus.
     if (_cePin != _csnPin) { 
-        if (digitalRead(_cePin) == LOW) digitalWrite(_cePin, HIGH); 
+        if (ceRead() == LOW) ceWrite(HIGH); 
     }
     
-    // If the radio was initially powered off, wait for it to turn on.
-    // 1500 uS = Powered Off mode to Standby mode transition time + 130 uS Standby to RX mode.
-    if ((originalConfigReg & _BV(PWR_UP)) == 0) { delayMicroseconds(1630); }
+    // If the radio was powered off, there's no need to wait for it to turn on.  With CE HIGH it enters RX mode by
+    // itself once it has started, and a packet cannot have been received before then anyway.  Sending waits for
+    // whatever remains of the start up time, see 'getPowerUpWaitMicros'.
 
     // If we have a pipe 1 packet sitting at the top of the RX FIFO buffer, we have data.
-    // We listen for data from other radios using the pipe 1 address.
-    if (getPipeOfFirstRxFifoPacket() == 1) {
-        return getRxFifoPacketLength(); // Return the length of the data packet in the RX FIFO buffer.
+    // We listen for data from other radios using the pipe 1 address, along with pipes 2-5 in hub mode.
+    // Pipe 0 packets are auto-acknowledgment data, and pipe numbers above 5 mean the RX FIFO buffer is empty.
+    uint8_t pipe;
+    uint8_t dataLength = getRxFifoPacketLength(pipe);
+    
+    if (pipe > 0 && pipe < 6) {
+        _rxPipe = pipe;
+        _rxLengthAverage = (_rxLengthAverage * 3 + dataLength) / 4;
+        if (_rxPacketCount < 255) { _rxPacketCount++; }
+        _isDrainingRx = isPolling;
+        stats(_stats.RxWaitMicros += micros() - _rxEmptyMicros);
+        return dataLength; // Return the length of the data packet in the RX FIFO buffer.
     }
     else {
+        _isDrainingRx = 0;
+        stats(_rxEmptyMicros = micros());
         return 0;
     }
 }
@@ -195,101 +330,327 @@ void NRFLite::readData(void* data)
     // Determine length of data in the RX FIFO buffer and read it.
     uint8_t dataLength;
     spiTransfer(READ_OPERATION, R_RX_PL_WID, &dataLength, 1);
-    spiTransfer(READ_OPERATION, R_RX_PAYLOAD, data, dataLength);
+    uint8_t statusReg = spiTransfer(READ_OPERATION, R_RX_PAYLOAD, data, dataLength);
+    
+    // Clear data received flag, using the STATUS register the radio provided while we read the data.
+    if (statusReg & _BV(RX_DR)) {
+        writeRegister(STATUS, _BV(RX_DR));
+    }
+}
+
+uint8_t NRFLite::readData(void* data, uint8_t maxLength)
+{
+    uint8_t* intData = reinterpret_cast<uint8_t*>(data);
+    uint8_t dataLength;
+    spiTransfer(READ_OPERATION, R_RX_PL_WID, &dataLength, 1);
+    
+    // The whole packet is clocked out so it is removed from the RX FIFO buffer, keeping only what fits.
+    uint8_t statusReg = spiBegin(R_RX_PAYLOAD);
+    
+    for (uint8_t i = 0; i < dataLength; ++i) {
+        uint8_t newData = transportTransfer(0);
+        if (i < maxLength) { intData[i] = newData; }
+    }
+    
+    spiEnd(R_RX_PAYLOAD, statusReg, dataLength);
+    
+    if (statusReg & _BV(RX_DR)) {
+        writeRegister(STATUS, _BV(RX_DR));
+    }
+    
+    return dataLength;
+}
+
+uint8_t NRFLite::readData(ReceiveCallback callback)
+{
+    uint8_t dataLength;
+    spiTransfer(READ_OPERATION, R_RX_PL_WID, &dataLength, 1);
+    
+    uint8_t statusReg = spiBegin(R_RX_PAYLOAD);
+    for (uint8_t i = 0; i < dataLength; ++i) { callback(transportTransfer(0), i); }
+    spiEnd(R_RX_PAYLOAD, statusReg, dataLength);
     
-    // Clear data received flag.
-    uint8_t statusReg = readRegister(STATUS);
     if (statusReg & _BV(RX_DR)) {
-        writeRegister(STATUS, readRegister(STATUS) | _BV(RX_DR));
+        writeRegister(STATUS, _BV(RX_DR));
     }
+    
+    return dataLength;
 }
 
-uint8_t NRFLite::send(uint8_t toRadioId, void* data, uint8_t length, SendType sendType)
+uint8_t NRFLite::send(uint8_t toRadioId, void* data, uint8_t length, SendType sendType, uint8_t toPipe)
 {
-    prepForTransmission(toRadioId, sendType);
+    Segment segment = { data, length };
+    return send(toRadioId, &segment, 1, sendType, toPipe);
+}
+
+uint8_t NRFLite::send(uint8_t toRadioId, const Segment* segments, uint8_t segmentCount, SendType sendType, uint8_t toPipe)
+{
+    prepForTransmission(toRadioId, sendType, toPipe);
 
     // Clear any previously asserted TX success or max retries flags.
-    uint8_t statusReg = readRegister(STATUS);
+    uint8_t statusReg = readStatus();
     if (statusReg & _BV(TX_DS) || statusReg & _BV(MAX_RT)) {
-        writeRegister(STATUS, statusReg | _BV(TX_DS) | _BV(MAX_RT));
+        writeRegister(STATUS, statusReg & (_BV(TX_DS) | _BV(MAX_RT)));
     }
     
     // Add data to the TX FIFO buffer, with or without an ACK request.
-    if (sendType == NO_ACK) { spiTransfer(WRITE_OPERATION, W_TX_PAYLOAD_NO_ACK, data, length); }
-    else                    { spiTransfer(WRITE_OPERATION, W_TX_PAYLOAD       , data, length); }
+    uint8_t length = writeTxPayload(segments, segmentCount, sendType);
 
     // Start transmission.
     // If we have separate pins for CE and CSN, CE will be LOW and we must pulse it to start transmission.
     // If we use the same pin for CE and CSN, CE will already be HIGH and transmission will have started
     // when data was loaded into the TX FIFO.  CSN is kept HIGH so the radio does not listen to the SPI bus.
     if (_cePin != _csnPin) {
-        digitalWrite(_cePin, HIGH);
-        delayMicroseconds(11); // 10 uS = Required CE time to initiate data transmission.
-        digitalWrite(_cePin, LOW);
+        ceWrite(HIGH);
+        waitMicros(11); // 10 uS = Required CE time to initiate data transmission.
+        ceWrite(LOW);
     }
     
-    // Wait for transmission to succeed or fail.
+    // Wait for transmission to succeed or fail.  The first check is when a successful transmission is complete:
+    // 130 uS to enter TX mode and the packet's airtime, plus if an ACK is required, 130 uS for the receiver to
+    // enter TX mode and the airtime of an ACK packet without data.  ACK packets with data or retries take longer,
+    // so later checks are at multiples of the retry wait, as they would be without the first check.  Checking brings
+    // CE LOW when it shares a pin with CSN, but the radio finishes the packet and its retries regardless of CE, so an
+    // early check only changes how soon 'send' returns and the next packet can start.
+    uint16_t checkMicros = 130 + _frameMicros + length * _byteMicros;
+    if (sendType == REQUIRE_ACK) { checkMicros += 130 + _frameMicros; }
+    uint16_t nextCheckMicros = _transmissionRetryWaitMicros - checkMicros % _transmissionRetryWaitMicros;
+    
     while (1) {
         
-        delayMicroseconds(_transmissionRetryWaitMicros);
+        waitMicros(checkMicros);
+        checkMicros = nextCheckMicros;
+        nextCheckMicros = _transmissionRetryWaitMicros;
         
-        statusReg = readRegister(STATUS);
+        statusReg = readStatus();
         
         if (statusReg & _BV(TX_DS)) {
-            writeRegister(STATUS, statusReg | _BV(TX_DS));   // Clear TX success flag.
+            writeRegister(STATUS, _BV(TX_DS));               // Clear TX success flag.
+            stats(_stats.PacketsAcked++; _stats.Retries += readRegister(OBSERVE_TX) & 0x0F);
             return 1;                                        // Return success.
         }
         else if (statusReg & _BV(MAX_RT)) {
             spiTransfer(WRITE_OPERATION, FLUSH_TX, NULL, 0); // Clear TX FIFO buffer.
-            writeRegister(STATUS, statusReg | _BV(MAX_RT));  // Clear flag which indicates max retries has been reached.
+            writeRegister(STATUS, _BV(MAX_RT));              // Clear flag which indicates max retries has been reached.
+            stats(_stats.PacketsFailed++; _stats.Retries += readRegister(OBSERVE_TX) & 0x0F);
             return 0;                                        // Return failure.
         }
     }
 }
 
-void NRFLite::startSend(uint8_t toRadioId, void* data, uint8_t length, SendType sendType)
+void NRFLite::startSend(uint8_t toRadioId, void* data, uint8_t length, SendType sendType, uint8_t toPipe)
+{
+    Segment segment = { data, length };
+    startSend(toRadioId, &segment, 1, sendType, toPipe);
+}
+
+void NRFLite::startSend(uint8_t toRadioId, const Segment* segments, uint8_t segmentCount, SendType sendType, uint8_t toPipe)
 {
-    prepForTransmission(toRadioId, sendType);
+    prepForTransmission(toRadioId, sendType, toPipe);
     
     // Add data to the TX FIFO buffer, with or without an ACK request.
-    if (sendType == NO_ACK) { spiTransfer(WRITE_OPERATION, W_TX_PAYLOAD_NO_ACK, data, length); }
-    else                    { spiTransfer(WRITE_OPERATION, W_TX_PAYLOAD       , data, length); }
+    writeTxPayload(segments, segmentCount, sendType);
     
     // Start transmission.
     if (_cePin != _csnPin) {
-        digitalWrite(_cePin, HIGH);
-        delayMicroseconds(11); // 10 uS = Required CE time to initiate data transmission.
-        digitalWrite(_cePin, LOW);
+        ceWrite(HIGH);
+        waitMicros(11); // 10 uS = Required CE time to initiate data transmission.
+        ceWrite(LOW);
     }
 }
 
 void NRFLite::whatHappened(uint8_t& tx_ok, uint8_t& tx_fail, uint8_t& rx_ready)
 {
-    uint8_t statusReg = readRegister(STATUS);
+    uint8_t statusReg = readStatus();
     
     tx_ok = statusReg & _BV(TX_DS);
     tx_fail = statusReg & _BV(MAX_RT);
     rx_ready = statusReg & _BV(RX_DR);
     
+    stats(if (tx_ok) _stats.PacketsAcked++; if (tx_fail) _stats.PacketsFailed++);
+    
     // When we need to see interrupt flags, we disable the logic here which clears them.
     // Programs that have an interrupt handler for the radio's IRQ pin will use 'whatHappened'
     // and if we don't disable this logic, it's not possible for us to check these flags.
+    // Only the flags we saw are cleared, so any set after we read STATUS still cause another interrupt.
     if (_enableInterruptFlagsReset) {
-        writeRegister(STATUS, statusReg | _BV(TX_DS) | _BV(MAX_RT) | _BV(RX_DR));
+        writeRegister(STATUS, statusReg & (_BV(TX_DS) | _BV(MAX_RT) | _BV(RX_DR)));
     }
 }
 
 void NRFLite::powerDown()
 {
     // If we have separate CE and CSN pins, we can gracefully stop listening or transmitting.
-    if (_cePin != _csnPin) { digitalWrite(_cePin, LOW); }
+    if (_cePin != _csnPin) { ceWrite(LOW); }
     
     // Turn off the radio.  Only consumes around 900 nA in this state!
     writeRegister(CONFIG, readRegister(CONFIG) & ~_BV(PWR_UP));
 }
 
+void NRFLite::resyncRegisters()
+{
+    _registerCacheFlags = 0;
+}
+
+void NRFLite::setChannel(uint8_t channel)
+{
+    if (channel > 125) { channel = 125; }
+    
+    // The radio tunes to the channel as it enters RX or TX mode, so if it is listening, CE is brought LOW for the
+    // change.  When CE and CSN share a pin, this happens during the SPI transaction.
+    uint8_t isListening = _cePin != _csnPin && ceRead() == HIGH;
+    
+    if (isListening) { ceWrite(LOW); }
+    writeRegister(RF_CH, channel);
+    if (isListening) { ceWrite(HIGH); }
+}
+
+void NRFLite::scanChannels(uint8_t activity[126], uint8_t samplesPerChannel)
+{
+    uint8_t originalChannel = beginChannelScan();
+    
+    for (uint8_t channel = 0; channel <= 125; channel++) {
+        activity[channel] = sampleChannel(channel, samplesPerChannel);
+    }
+    
+    endChannelScan(originalChannel);
+}
+
+uint8_t NRFLite::getQuietestChannel(uint8_t samplesPerChannel)
+{
+    uint8_t originalChannel = beginChannelScan();
+    uint8_t quietestChannel = originalChannel;
+    uint16_t quietestScore = 0xFFFF;
+    
+    // A channel's score is twice its own activity plus the activity of the channels either side, so it is known once
+    // the next channel has been sampled.  Channels 0 and 125 use their own activity for the missing neighbour.
+    uint8_t before = 0, current = 0;
+    
+    for (uint8_t channel = 0; channel <= 126; channel++) {
+        
+        uint8_t after = channel <= 125 ? sampleChannel(channel, samplesPerChannel) : current;
+        
+        if (channel == 0) {
+            before = current = after;
+            continue;
+        }
+        
+        uint16_t score = 2 * current + before + after;
+        
+        if (score < quietestScore) {
+            quietestScore = score;
+            quietestChannel = channel - 1;
+        }
+        
+        before = current;
+        current = after;
+    }
+    
+    endChannelScan(originalChannel);
+    return quietestChannel;
+}
+
+void NRFLite::setRetries(uint8_t retryDelaySteps, uint8_t retryCount)
+{
+    if (retryDelaySteps < 1)  { retryDelaySteps = 1; }
+    if (retryDelaySteps > 16) { retryDelaySteps = 16; }
+    if (retryCount > 15)      { retryCount = 15; }
+    
+    // Retry time  = SETUP_RETR upper 4 bits (0 = 250 uS, 1 = 500 us, 2 = 750 us, ... , 15 = 4000 us).
+    // Retry count = SETUP_RETR lower 4 bits (0 to 15).
+    // 'send' checks on the radio about once per retry after its first check, so the wait follows the retry time.
+    writeRegister(SETUP_RETR, ((retryDelaySteps - 1) << ARD) | retryCount);
+    _transmissionRetryWaitMicros = retryDelaySteps * 250;
+}
+
+void NRFLite::setSpiClock(uint32_t clock)
+{
+    _spiClock = clock;
+}
+
+void NRFLite::spiUsingInterrupt(uint8_t interruptNumber)
+{
+    // The SPI library holds off the interrupt during the transactions of every device that uses them, not only ours,
+    // and so do USI transfers since '_spiUsesInterrupts' is shared by every radio.
+    _spiUsesInterrupts = 1;
+    
+    #if !defined(NRFLITE_EXTERNAL_TRANSPORT) && !defined(__AVR_ATtiny84__) && !defined(__AVR_ATtiny85__) && defined(SPI_HAS_TRANSACTION)
+    SPI.usingInterrupt(interruptNumber);
+    #else
+    (void)interruptNumber;
+    #endif
+}
+
+#if NRFLITE_STATS
+
+NRFLite::Stats NRFLite::getStats()
+{
+    // The counters can be changed by an interrupt handler using the radio, so prevent that while they are copied.
+    // On AVR the interrupt state is restored rather than enabled, so this can be called from an interrupt handler or
+    // with interrupts disabled.  Other boards have no common way to read the interrupt state, so there interrupts are
+    // enabled afterwards.
+    #if defined(__AVR__)
+    uint8_t oldSREG = SREG;
+    cli();
+    Stats snapshot = _stats;
+    SREG = oldSREG;
+    #else
+    noInterrupts();
+    Stats snapshot = _stats;
+    interrupts();
+    #endif
+    return snapshot;
+}
+
+void NRFLite::resetStats()
+{
+    #if defined(__AVR__)
+    uint8_t oldSREG = SREG;
+    cli();
+    memset(&_stats, 0, sizeof(_stats));
+    SREG = oldSREG;
+    #else
+    noInterrupts();
+    memset(&_stats, 0, sizeof(_stats));
+    interrupts();
+    #endif
+}
+
+#endif
+
+#if NRFLITE_TRACE
+
+void NRFLite::printTrace()
+{
+    // Oldest event first, which is the next one to be overwritten once the buffer is full.
+    uint16_t eventCount = _traceIsFull ? NRFLITE_TRACE_LENGTH : _traceNextEvent;
+    uint16_t index = _traceIsFull ? _traceNextEvent : 0;
+    
+    if (_serial) {
+        
+        _serial->println("NRFLITE_TRACE");
+        
+        for (uint16_t i = 0; i < eventCount; i++) {
+            TraceEvent& event = _traceEvents[index];
+            _serial->print(event.Micros, HEX); _serial->print(' ');
+            _serial->print(event.Type, HEX);   _serial->print(' ');
+            _serial->println(event.Value, HEX);
+            if (++index == NRFLITE_TRACE_LENGTH) { index = 0; }
+        }
+        
+        _serial->println("NRFLITE_TRACE_END");
+    }
+    
+    _traceNextEvent = 0;
+    _traceIsFull = 0;
+}
+
+#endif
+
 void NRFLite::printDetails()
 {
+    resyncRegisters(); // Ensure we print what the radio contains rather than what we remember writing to it.
+    
     printRegister("CONFIG", readRegister(CONFIG));
     printRegister("EN_AA", readRegister(EN_AA));
     printRegister("EN_RXADDR", readRegister(EN_RXADDR));
@@ -297,7 +658,7 @@ void NRFLite::printDetails()
     printRegister("SETUP_RETR", readRegister(SETUP_RETR));
     printRegister("RF_CH", readRegister(RF_CH));
     printRegister("RF_SETUP", readRegister(RF_SETUP));
-    printRegister("STATUS", readRegister(STATUS));
+    printRegister("STATUS", readStatus());
     printRegister("OBSERVE_TX", readRegister(OBSERVE_TX));
     printRegister("RX_PW_P0", readRegister(RX_PW_P0));
     printRegister("RX_PW_P1", readRegister(RX_PW_P1));
@@ -308,18 +669,18 @@ void NRFLite::printDetails()
     uint8_t data[5];
     
     debug("TX_ADDR = ");
-    readRegister(TX_ADDR, &data, 5);
-    for (uint8_t i=0; i<5; i++) debug(data[i]);
+    readRegister(TX_ADDR, &data, _addressWidth);
+    for (uint8_t i=0; i<_addressWidth; i++) debug(data[i]);
     debugln();
     
     debug("RX_ADDR_P0 = ");
-    readRegister(RX_ADDR_P0, &data, 5);
-    for (uint8_t i=0; i<5; i++) debug(data[i]);
+    readRegister(RX_ADDR_P0, &data, _addressWidth);
+    for (uint8_t i=0; i<_addressWidth; i++) debug(data[i]);
     debugln();
     
     debug("RX_ADDR_P1 = ");
-    readRegister(RX_ADDR_P1, &data, 5);
-    for (uint8_t i=0; i<5; i++) debug(data[i]);
+    readRegister(RX_ADDR_P1, &data, _addressWidth);
+    for (uint8_t i=0; i<_addressWidth; i++) debug(data[i]);
     debugln();
     debugln();
 }
@@ -328,21 +689,24 @@ void NRFLite::printDetails()
 // Private methods //
 /////////////////////
 
-uint8_t NRFLite::getPipeOfFirstRxFifoPacket()
+uint8_t NRFLite::getRxFifoPacketLength(uint8_t& pipe)
 {
+    // Read the length of the first data packet sitting in the RX FIFO buffer.
+    // The radio clocks out the STATUS register at the start of the command, and it tells us which pipe
+    // the packet was received on, so we don't need a separate transaction to read it.
+    uint8_t dataLength;
+    uint8_t statusReg = spiTransfer(READ_OPERATION, R_RX_PL_WID, &dataLength, 1);
+    
     // The pipe number is bits 3, 2, and 1.  So B1110 masks them and we shift right by 1 to get the pipe number.
     // Any value > 5 is not a pipe number.
     // 000-101 = Data Pipe Number
     //     110 = Not Used
     //     111 = RX FIFO Empty
-    return (readRegister(STATUS) & B1110) >> 1;
-}
-
-uint8_t NRFLite::getRxFifoPacketLength()
-{
-    // Read the length of the first data packet sitting in the RX FIFO buffer.
-    uint8_t dataLength;
-    spiTransfer(READ_OPERATION, R_RX_PL_WID, &dataLength, 1);
+    pipe = (statusReg & B1110) >> 1;
+    
+    if (pipe > 5) {
+        return 0; // The length is not valid when the RX FIFO buffer is empty.
+    }
 
     // As specified in the datasheet, we verify the data length is valid (0 - 32 bytes).
     if (dataLength > 32) {
@@ -354,42 +718,144 @@ uint8_t NRFLite::getRxFifoPacketLength()
     }
 }
 
-void NRFLite::prepForTransmission(uint8_t toRadioId, SendType sendType)
+void NRFLite::updateDataCheckInterval()
 {
+    // With CE and CSN sharing a pin, every check of the radio brings CE LOW, and a packet is only received if CE then
+    // stays HIGH for 130 uS to enter RX mode, the packet's airtime, and 130 uS plus the airtime of the ACK packet sent
+    // back.  'hasData' checks the radio no more often than '_allowedDataCheckIntervalMicros', which was tuned for 32 byte
+    // packets.  During a burst of packets averaging no more than '_shortPacketLength' bytes, arriving within 6 of these
+    // minimum windows of each other, the interval is scaled down by the shorter airtime so they are found sooner.
+    // Other packets keep the tuned interval since shorter ones measured slower, cutting off more packets than they found.
+    _dataCheckIntervalMicros = _allowedDataCheckIntervalMicros;
+    
+    if (_rxLengthAverage <= _shortPacketLength) {
+        uint16_t packetMicros = 260 + 2 * _frameMicros + _rxLengthAverage * _byteMicros;
+        uint16_t maxPacketMicros = 260 + 2 * _frameMicros + 32 * _byteMicros;
+        
+        if (_rxArrivalMicros < packetMicros * 6UL) {
+            _dataCheckIntervalMicros = (uint32_t)_allowedDataCheckIntervalMicros * packetMicros / maxPacketMicros;
+        }
+    }
+}
+
+uint8_t NRFLite::beginChannelScan()
+{
+    // RPD only works in RX mode, so ensure the radio is powered on and listening.  Returns the channel to go back to.
+    uint8_t originalConfigReg = readRegister(CONFIG);
+    uint8_t newConfigReg = originalConfigReg | _BV(PWR_UP) | _BV(PRIM_RX);
+    
+    if (originalConfigReg != newConfigReg) {
+        if (_cePin != _csnPin && ceRead() == HIGH) { ceWrite(LOW); } // RX mode is entered from Standby-I.
+        writeRegister(CONFIG, newConfigReg);
+    }
+    
+    // RPD samples are only valid once the radio has started.
+    waitMicros(getPowerUpWaitMicros());
+    
+    return readRegister(RF_CH);
+}
+
+void NRFLite::endChannelScan(uint8_t channel)
+{
+    // Listen on the original channel again.  CE is LOW after sampling when it has its own pin.
+    writeRegister(RF_CH, channel);
+    if (_cePin != _csnPin) { ceWrite(HIGH); }
+}
+
+uint8_t NRFLite::sampleChannel(uint8_t channel, uint8_t samples)
+{
+    // RPD is set when a signal above -64 dBm lasts 40 uS in RX mode, and cleared as RX mode is left.  So for each sample
+    // the radio enters RX mode, listens, and leaves again after we read RPD.  With CE and CSN on the same pin, CE is
+    // HIGH while we wait but goes LOW in the same SPI transaction that reads RPD, and no read can avoid that, so the
+    // samples are not reliable and 'scanChannels' documents that it needs separate pins.
+    uint8_t activeCount = 0;
+    
+    if (_cePin != _csnPin) { ceWrite(LOW); }
+    writeRegister(RF_CH, channel);
+    
+    for (uint8_t i = 0; i < samples; i++) {
+        if (_cePin != _csnPin) { ceWrite(HIGH); }
+        waitMicros(170); // 130 uS to enter RX mode + 40 uS for RPD.
+        if (readRegister(RPD) & 1) { activeCount++; }
+        if (_cePin != _csnPin) { ceWrite(LOW); }
+    }
+    
+    return activeCount;
+}
+
+void NRFLite::getAddress(uint8_t pipe, uint8_t radioId, uint8_t* address)
+{
+    // The pipe number, the prefix bytes that fit, and then the radio id, lowest byte first as the radio expects.
+    address[0] = pipe;
+    for (uint8_t i = 1; i < _addressWidth - 1; i++) { address[i] = _addressPrefix[i - 1]; }
+    address[_addressWidth - 1] = radioId;
+}
+
+void NRFLite::forgetTxAddress()
+{
+    // For code that writes TX_ADDR or RX_ADDR_P0 itself, so the next transmission writes the destination's address again.
+    _registerCacheFlags &= ~_BV(CACHED_TX_ADDR);
+}
+
+uint16_t NRFLite::enterTxMode(uint8_t toRadioId, uint8_t toPipe)
+{
+    // Sets up the radio for TX operation and returns the number of microseconds it needs before it can transmit.
+    // Callers that cannot block can do other work during this time rather than waiting.
+    
     // TX pipe address sets the destination radio for the data.
     // RX pipe 0 is special and needs the same address in order to receive auto-acknowledgment packets
-    // from the destination radio.
-    uint8_t address[5] = { 1, 2, 3, 4, toRadioId };
-    writeRegister(TX_ADDR, &address, 5);
-    writeRegister(RX_ADDR_P0, &address, 5);
+    // from the destination radio.  Both are skipped when we are sending to the same radio as last time.
+    if ((_registerCacheFlags & _BV(CACHED_TX_ADDR)) && _txRadioId == toRadioId && _txPipe == toPipe) {
+        stats(_stats.SpiBytesSaved += 2 + _addressWidth * 2);
+    }
+    else {
+        uint8_t address[5];
+        getAddress(toPipe, toRadioId, address);
+        writeRegister(TX_ADDR, &address, _addressWidth);
+        writeRegister(RX_ADDR_P0, &address, _addressWidth);
+        _txRadioId = toRadioId;
+        _txPipe = toPipe;
+        _registerCacheFlags |= _BV(CACHED_TX_ADDR);
+    }
     
     // Ensure radio is powered on and ready for TX operation.
     uint8_t originalConfigReg = readRegister(CONFIG);
-    uint8_t newConfigReg = originalConfigReg & ~_BV(PRIM_RX) | _BV(PWR_UP);
+    uint8_t newConfigReg = (originalConfigReg & ~_BV(PRIM_RX)) | _BV(PWR_UP);
     if (originalConfigReg != newConfigReg) {
 
         // In case the radio was in RX mode (powered on and listening), we'll put the radio into
         // Standby-I mode by setting CE LOW.  The radio cannot transition directly from RX to TX,
         // it must go through Standby-I first.
         if ((originalConfigReg & _BV(PRIM_RX)) && (originalConfigReg & _BV(PWR_UP))) {
-            if (digitalRead(_cePin) == HIGH) { digitalWrite(_cePin, LOW); }
+            if (ceRead() == HIGH) { ceWrite(LOW); }
         }
         
         writeRegister(CONFIG, newConfigReg);
-        
-        // 1500 uS = Powered Off mode to Standby-I mode transition time + 130 uS Standby to TX.
-        delayMicroseconds(1630);
     }
     
+    // Standby-I and RX mode are left immediately, and the 130 uS from Standby to TX mode happens after CE is
+    // pulsed, within the time we wait for the transmission to finish.  So only a radio that is still starting up
+    // needs time before it can transmit.
+    return getPowerUpWaitMicros();
+}
+
+void NRFLite::prepForTransmission(uint8_t toRadioId, SendType sendType, uint8_t toPipe)
+{
+    // Wait for the radio to be ready for TX operation.
+    waitMicros(enterTxMode(toRadioId, toPipe));
+    
     // If RX FIFO buffer is full and we require an ACK, clear it so we can receive the ACK response.
     uint8_t fifoReg = readRegister(FIFO_STATUS);
     if (fifoReg & _BV(RX_FULL) && sendType == REQUIRE_ACK) {
         spiTransfer(WRITE_OPERATION, FLUSH_RX, NULL, 0);
+        stats(_stats.RxFifoFullEvents++);
     }
     
     // If TX FIFO buffer is full, we'll attempt to send all the packets it contains.
     if (fifoReg & _BV(FIFO_FULL)) {
         
+        stats(_stats.TxFifoFullEvents++);
+        
         // We need to see radio interrupt flags here to determine if transmission was successful or not.
         // Programs that utilize the interrupt capability of this library call 'whatHappened'
         // in their radio IRQ pin handler to determine if a transmission succeeded or failed, and in this method we
@@ -403,20 +869,22 @@ void NRFLite::prepForTransmission(uint8_t toRadioId, SendType sendType)
         while (!(fifoReg & _BV(TX_EMPTY))) {
             
             // Try sending a packet.
-            digitalWrite(_cePin, HIGH);
-            delayMicroseconds(11);       // 10 uS = Required CE time to initiate data transmission.
-            digitalWrite(_cePin, LOW);
+            ceWrite(HIGH);
+            waitMicros(11);              // 10 uS = Required CE time to initiate data transmission.
+            ceWrite(LOW);
             
-            delayMicroseconds(_transmissionRetryWaitMicros);
+            waitMicros(_transmissionRetryWaitMicros);
             
-            statusReg = readRegister(STATUS);
+            statusReg = readStatus();
             
             if (statusReg & _BV(TX_DS)) {
-                writeRegister(STATUS, statusReg | _BV(TX_DS));   // Clear TX success flag.
+                writeRegister(STATUS, _BV(TX_DS));               // Clear TX success flag.
+                stats(_stats.PacketsAcked++);
             }
             else if (statusReg & _BV(MAX_RT)) {
                 spiTransfer(WRITE_OPERATION, FLUSH_TX, NULL, 0); // Clear TX FIFO buffer.
-                writeRegister(STATUS, statusReg | _BV(MAX_RT));  // Clear flag which indicates max retries has been reached.
+                writeRegister(STATUS, _BV(MAX_RT));              // Clear flag which indicates max retries has been reached.
+                stats(_stats.PacketsFailed++);
             }
 
             fifoReg = readRegister(FIFO_STATUS);
@@ -426,10 +894,45 @@ void NRFLite::prepForTransmission(uint8_t toRadioId, SendType sendType)
     }
 }
 
+uint8_t NRFLite::writeTxPayload(const Segment* segments, uint8_t segmentCount, SendType sendType)
+{
+    // Writes the segments to the TX FIFO buffer as one packet, in a single SPI transaction, and returns its length.
+    uint8_t regName = sendType == NO_ACK ? W_TX_PAYLOAD_NO_ACK : W_TX_PAYLOAD;
+    uint8_t length = 0;
+    uint8_t statusReg = spiBegin(regName);
+    
+    for (uint8_t s = 0; s < segmentCount; s++) {
+        
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(segments[s].Data);
+        
+        for (uint8_t i = 0; i < segments[s].Length && length < 32; i++, length++) {
+            transportTransfer(data[i]);
+        }
+    }
+    
+    spiEnd(regName, statusReg, length);
+    stats(_stats.PacketsSent++);
+    return length;
+}
+
 uint8_t NRFLite::readRegister(uint8_t regName)
 {
+    // Configuration registers are only changed by us, so if we have a copy there is no need to ask the radio.
+    uint8_t isCacheable = regName < STATUS;
+    
+    if (isCacheable && (_registerCacheFlags & _BV(regName))) {
+        stats(_stats.SpiBytesSaved += 2);
+        return _registerCache[regName];
+    }
+    
     uint8_t data;
     readRegister(regName, &data, 1);
+    
+    if (isCacheable) {
+        _registerCache[regName] = data;
+        _registerCacheFlags |= _BV(regName);
+    }
+    
     return data;
 }
 
@@ -440,6 +943,28 @@ void NRFLite::readRegister(uint8_t regName, void* data, uint8_t length)
 
 void NRFLite::writeRegister(uint8_t regName, uint8_t data)
 {
+    // Skip writing configuration registers that already contain the value.
+    if (regName < STATUS) {
+        
+        uint8_t isCached = _registerCacheFlags & _BV(regName);
+        
+        if (isCached && _registerCache[regName] == data) {
+            stats(_stats.SpiBytesSaved += 2);
+            return;
+        }
+        
+        // Note when the radio is powered on, assuming it was off if CONFIG is not known.
+        if (regName == CONFIG && (data & _BV(PWR_UP)) && !(isCached && (_registerCache[CONFIG] & _BV(PWR_UP)))) {
+            _powerUpMicros = micros();
+            _isPoweringUp = 1;
+        }
+        
+        _registerCache[regName] = data;
+        _registerCacheFlags |= _BV(regName);
+    }
+    
+    if (regName == CONFIG) { trace(TRACE_CONFIG, data); }
+    
     writeRegister(regName, &data, 1);
 }
 
@@ -448,40 +973,185 @@ void NRFLite::writeRegister(uint8_t regName, void* data, uint8_t length)
     spiTransfer(WRITE_OPERATION, (W_REGISTER | (REGISTER_MASK & regName)), data, length);
 }
 
-void NRFLite::spiTransfer(SpiTransferType transferType, uint8_t regName, void* data, uint8_t length)
+uint16_t NRFLite::getPowerUpWaitMicros()
+{
+    // The radio needs 1500 uS after being powered on before it can enter TX or RX mode.  Rather than always waiting
+    // this long, the start time is remembered and only the part that has not passed yet is returned.
+    if (_isPoweringUp) {
+        uint32_t elapsedMicros = micros() - _powerUpMicros;
+        if (elapsedMicros < POWER_UP_MICROS) { return POWER_UP_MICROS - elapsedMicros; }
+        _isPoweringUp = 0;
+    }
+    
+    return 0;
+}
+
+uint8_t NRFLite::readStatus()
+{
+    // NOP is a single byte command, the STATUS register comes back while it is sent.
+    return spiTransfer(WRITE_OPERATION, NOP, NULL, 0);
+}
+
+void NRFLite::waitMicros(uint16_t microseconds)
+{
+    // All waits on the radio go through here so the time they take can be counted.
+    if (microseconds > 0) { trace(TRACE_WAIT, microseconds > 4080 ? 255 : (microseconds + 15) / 16); }
+    delayMicroseconds(microseconds);
+    stats(_stats.WaitMicros += microseconds);
+}
+
+#if NRFLITE_TRACE
+
+void NRFLite::addTraceEvent(uint8_t type, uint8_t value)
+{
+    // Events are small and fixed size so recording one takes little time.  Once the buffer is full the oldest
+    // event is overwritten.
+    TraceEvent& event = _traceEvents[_traceNextEvent];
+    event.Micros = micros();
+    event.Type = type;
+    event.Value = value;
+    
+    if (++_traceNextEvent == NRFLITE_TRACE_LENGTH) {
+        _traceNextEvent = 0;
+        _traceIsFull = 1;
+    }
+}
+
+#endif
+
+uint8_t NRFLite::spiTransfer(SpiTransferType transferType, uint8_t regName, void* data, uint8_t length)
 {
     uint8_t* intData = reinterpret_cast<uint8_t*>(data);
+    uint8_t statusReg = spiBegin(regName);
     
-    digitalWrite(_csnPin, LOW); // Signal radio it should begin listening to the SPI bus.
+    for (uint8_t i = 0; i < length; ++i) {
+        // Reads clock out zeros rather than whatever the buffer held, which the radio ignores.
+        if (transferType == READ_OPERATION) { intData[i] = transportTransfer(0); }
+        else                                { transportTransfer(intData[i]); }
+    }
     
-    #if defined(__AVR_ATtiny84__) || defined(__AVR_ATtiny85__)
+    spiEnd(regName, statusReg, length);
+    return statusReg;
+}
+
+uint8_t NRFLite::spiBegin(uint8_t regName)
+{
+    // Starts an SPI transaction with the command, after which the data bytes are transferred by the caller.
+    trace(TRACE_SPI, regName);
     
-    // ATtiny transfer with USI.
+    transportBeginTransaction();
+    csnWrite(LOW); // Signal radio it should begin listening to the SPI bus.
     
-    usiTransfer(regName);
-    for (uint8_t i = 0; i < length; ++i) {
-        uint8_t newData = usiTransfer(intData[i]);
-        if (transferType == READ_OPERATION) { intData[i] = newData; }
+    // The radio always clocks out the STATUS register while it receives the command byte.
+    return transportTransfer(regName);
+}
+
+void NRFLite::spiEnd(uint8_t regName, uint8_t statusReg, uint8_t length)
+{
+    // Ends an SPI transaction started with 'spiBegin', where 'length' data bytes followed the command.
+    csnWrite(HIGH); // Stop radio from listening to the SPI bus.
+    transportEndTransaction();
+    
+    (void)regName; (void)statusReg; (void)length; // Only used by the trace and the counters, which may be disabled.
+    
+    #if NRFLITE_TRACE
+    // Every command provides the STATUS register, so this is where TX_DS, MAX_RT, and RX_DR are first seen.
+    if ((statusReg & (_BV(RX_DR) | _BV(TX_DS) | _BV(MAX_RT))) != _traceStatusFlags) {
+        _traceStatusFlags = statusReg & (_BV(RX_DR) | _BV(TX_DS) | _BV(MAX_RT));
+        trace(TRACE_STATUS, statusReg);
+    }
+    #endif
+    
+    #if NRFLITE_STATS
+    _stats.SpiTransactions++;
+    _stats.SpiBytes += length + 1;
+    
+    // These are counted here since several methods, including some in other classes, use them.
+    if (regName == FLUSH_RX)          { _stats.RxFifoFlushes++; }
+    else if (regName == FLUSH_TX)     { _stats.TxFifoFlushes++; }
+    else if (regName == R_RX_PAYLOAD) {
+        if ((statusReg & B1110) == 0) { _stats.AckPacketsReceived++; } // Pipe 0 packets are ACK packets.
+        else                          { _stats.PacketsReceived++;    }
     }
+    #endif
+}
+
+///////////////////////
+// Transport methods //
+///////////////////////
+
+// All communication with the radio, SPI bytes and the CE and CSN pins, goes through the following methods
+// so the transport can be selected at compile time.
+
+void NRFLite::transportBegin()
+{
+    #if defined(NRFLITE_EXTERNAL_TRANSPORT)
+    
+    nrfliteTransportBegin();
+    
+    #elif defined(__AVR_ATtiny84__) || defined(__AVR_ATtiny85__)
+    
+    pinMode(USI_DI, INPUT ); digitalWrite(USI_DI, HIGH);
+    pinMode(USI_DO, OUTPUT); digitalWrite(USI_DO, LOW);
+    pinMode(SCK, OUTPUT); digitalWrite(SCK, LOW);
     
     #else
     
-    // ATmega transfer with the Arduino SPI library.
+    // Arduino SPI makes SS (D10) an output and sets it HIGH.  It must remain an output
+    // for Master SPI operation to work, but in case it was originally LOW, we'll set it back.
+    // The clock is set at the start of each transaction rather than here, since a setting made here would apply to
+    // every device on the bus and be replaced by the next one to call 'init' or 'begin'.
+    uint8_t savedSS = digitalRead(SS);
+    #if !defined(SPI_HAS_TRANSACTION)
+    SPI.setClockDivider(SPI_CLOCK_DIV2);
+    #endif
+    SPI.begin();
+    if (_csnPin != SS) digitalWrite(SS, savedSS);
     
-    SPI.transfer(regName);
-    for (uint8_t i = 0; i < length; ++i) {
-        uint8_t newData = SPI.transfer(intData[i]);
-        if (transferType == READ_OPERATION) { intData[i] = newData; }
+    #endif
+}
+
+void NRFLite::transportBeginTransaction()
+{
+    #if defined(NRFLITE_EXTERNAL_TRANSPORT)
+    
+    // The program's transport is not shared with interrupt handlers.
+    
+    #elif defined(__AVR_ATtiny84__) || defined(__AVR_ATtiny85__)
+    
+    // USI has no transactions, so interrupt handlers using the radio are held off by disabling interrupts.
+    if (_spiUsesInterrupts) {
+        _spiSavedSREG = SREG;
+        cli();
     }
     
-    #endif
+    #elif defined(SPI_HAS_TRANSACTION)
+    
+    // Applies our clock and mode, and holds off any interrupts given to 'spiUsingInterrupt', until the transaction ends.
+    SPI.beginTransaction(SPISettings(_spiClock, MSBFIRST, SPI_MODE0));
     
-    digitalWrite(_csnPin, HIGH); // Stop radio from listening to the SPI bus.
+    #endif
+}
+
+void NRFLite::transportEndTransaction()
+{
+    #if defined(NRFLITE_EXTERNAL_TRANSPORT)
+    #elif defined(__AVR_ATtiny84__) || defined(__AVR_ATtiny85__)
+    if (_spiUsesInterrupts) { SREG = _spiSavedSREG; }
+    #elif defined(SPI_HAS_TRANSACTION)
+    SPI.endTransaction();
+    #endif
 }
 
-uint8_t NRFLite::usiTransfer(uint8_t data)
+uint8_t NRFLite::transportTransfer(uint8_t data)
 {
-    #if defined(__AVR_ATtiny84__) || defined(__AVR_ATtiny85__)
+    #if defined(NRFLITE_EXTERNAL_TRANSPORT)
+    
+    return nrfliteTransportTransfer(data);
+    
+    #elif defined(__AVR_ATtiny84__) || defined(__AVR_ATtiny85__)
+    
+    // ATtiny transfer with USI.
     
     USIDR = data;
     USISR = _BV(USIOIF);
@@ -493,10 +1163,71 @@ uint8_t NRFLite::usiTransfer(uint8_t data)
     
     return USIDR;
     
+    #else
+    
+    // ATmega transfer with the Arduino SPI library.
+    
+    return SPI.transfer(data);
+    
+    #endif
+}
+
+void NRFLite::transportPinMode(uint8_t pin, uint8_t mode)
+{
+    #if defined(NRFLITE_EXTERNAL_TRANSPORT)
+    nrfliteTransportPinMode(pin, mode);
+    #else
+    pinMode(pin, mode);
+    #endif
+}
+
+void NRFLite::ceWrite(uint8_t level)
+{
+    trace(TRACE_CE, level);
+    
+    #if defined(NRFLITE_EXTERNAL_TRANSPORT)
+    nrfliteTransportDigitalWrite(_cePin, level);
+    #elif defined(__AVR__)
+    // Interrupts are disabled during the read-modify-write of the port so an interrupt handler changing
+    // another pin on the same port cannot have its change overwritten.
+    uint8_t oldSREG = SREG;
+    cli();
+    if (level) { *_cePort |= _ceMask; }
+    else       { *_cePort &= ~_ceMask; }
+    SREG = oldSREG;
+    #else
+    digitalWrite(_cePin, level);
+    #endif
+}
+
+void NRFLite::csnWrite(uint8_t level)
+{
+    #if defined(NRFLITE_EXTERNAL_TRANSPORT)
+    nrfliteTransportDigitalWrite(_csnPin, level);
+    #elif defined(__AVR__)
+    uint8_t oldSREG = SREG;
+    cli();
+    if (level) { *_csnPort |= _csnMask; }
+    else       { *_csnPort &= ~_csnMask; }
+    SREG = oldSREG;
+    #else
+    digitalWrite(_csnPin, level);
+    #endif
+}
+
+uint8_t NRFLite::ceRead()
+{
+    #if defined(NRFLITE_EXTERNAL_TRANSPORT)
+    return nrfliteTransportDigitalRead(_cePin);
+    #elif defined(__AVR__)
+    // CE is an output so its port register holds the level we last wrote.
+    return (*_cePort & _ceMask) ? HIGH : LOW;
+    #else
+    return digitalRead(_cePin);
     #endif
 }
 
-void NRFLite::printRegister(char* name, uint8_t reg)
+void NRFLite::printRegister(const char* name, uint8_t reg)
 {
     debug(name);
     debug(" = ");
@@ -4,6 +4,61 @@
 #include <Arduino.h>
 #include <nRF24L01.h>
 
+// Transport selection.
+// By default the radio is driven using the Arduino SPI library, or USI when compiled for an ATtiny84/85.
+// Defining NRFLITE_EXTERNAL_TRANSPORT replaces the SPI bus and the CE and CSN pin access with the functions below,
+// which must then be provided by the program.  This allows the library to be compiled for other platforms, for
+// example against an nRF24L01+ emulator on a PC, so changes can be measured without flashing any boards.
+// extras/benchmark/nRF24L01Emulator.cpp is such a host backend, providing these functions for the benchmark.
+// nrfliteTransportTransfer = Clocks one byte out to the radio and returns the byte clocked in.
+#if defined(NRFLITE_EXTERNAL_TRANSPORT)
+void    nrfliteTransportBegin();
+uint8_t nrfliteTransportTransfer(uint8_t data);
+void    nrfliteTransportPinMode(uint8_t pin, uint8_t mode);
+void    nrfliteTransportDigitalWrite(uint8_t pin, uint8_t value);
+uint8_t nrfliteTransportDigitalRead(uint8_t pin);
+#endif
+
+// Statistics.
+// Each radio counts its packets, FIFO buffer events, SPI traffic, and time spent waiting, see 'getStats'.  The counters
+// use 56 bytes of RAM and a little time on each SPI transaction, so they can be removed by setting NRFLITE_STATS to 0.
+// They are removed by default on the ATtiny84/85.
+#ifndef NRFLITE_STATS
+    #if defined(__AVR_ATtiny84__) || defined(__AVR_ATtiny85__)
+        #define NRFLITE_STATS 0
+    #else
+        #define NRFLITE_STATS 1
+    #endif
+#endif
+
+// Event trace.
+// Setting NRFLITE_TRACE to 1 records the radio's activity in a ring buffer holding the last NRFLITE_TRACE_LENGTH events,
+// each with the 'micros' time it occurred, see 'printTrace'.  Each event uses 6 bytes of RAM.
+#ifndef NRFLITE_TRACE
+    #define NRFLITE_TRACE 0
+#endif
+#ifndef NRFLITE_TRACE_LENGTH
+    #define NRFLITE_TRACE_LENGTH 64
+#endif
+
+// SPI clock.
+// Each radio applies its own SPI settings at the start of every SPI transaction, see 'setSpiClock', so it can share the
+// SPI bus with other radios and devices that use different settings.  The radio supports up to 10 MHz.
+#ifndef NRFLITE_SPI_CLOCK
+    #define NRFLITE_SPI_CLOCK 8000000
+#endif
+
+// Keeps the typed 'send' and 'readData' from being chosen for pointer variables, like 'uint8_t* buffer'.  Those must
+// go to the 'void*' methods so the data they point to is used rather than the bytes of the pointer itself.
+template<typename T> struct NRFLiteIsPointer { static const bool value = false; };
+template<typename T> struct NRFLiteIsPointer<T*> { static const bool value = true; };
+template<typename T> struct NRFLiteIsPointer<T* const> { static const bool value = true; };
+// Arrays given to the typed 'readData' may be larger than a packet, as buffers given to the 'void*' method could be.
+template<typename T> struct NRFLiteIsArray { static const bool value = false; };
+template<typename T, unsigned N> struct NRFLiteIsArray<T[N]> { static const bool value = true; };
+template<bool Condition, typename T> struct NRFLiteEnableIf {};
+template<typename T> struct NRFLiteEnableIf<true, T> { typedef T type; };
+
 class NRFLite {
     
     public:
@@ -11,66 +66,263 @@ class NRFLite {
     // Constructors
     // You can pass in an Arduino Serial or SoftwareSerial object for use throughout the library when debugging.
     // This approach allows both Serial and SoftwareSerial support so debugging on ATtinys is easy.
-    NRFLite() {}
-    NRFLite(Stream& serial) : _serial(&serial) {}
+    NRFLite() : _spiClock(NRFLITE_SPI_CLOCK) {}
+    NRFLite(Stream& serial) : _serial(&serial), _spiClock(NRFLITE_SPI_CLOCK) {}
     
     enum Bitrates { BITRATE2MBPS, BITRATE1MBPS, BITRATE250KBPS };
     enum SendType { REQUIRE_ACK, NO_ACK };
     
+    // Part of a packet for the 'send' and 'startSend' methods that take several of them.
+    struct Segment { const void* Data; uint8_t Length; };
+    
+    // Called by 'readData' with each byte of a packet as it comes from the radio, see 'readData'.
+    typedef void (*ReceiveCallback)(uint8_t value, uint8_t index);
+    
+    #if NRFLITE_STATS
+    struct Stats {
+        uint32_t PacketsSent;        // Data packets started by any of the transmit methods.
+        uint32_t PacketsAcked;       // Transmissions that succeeded, including those not requiring an ACK.
+        uint32_t PacketsFailed;      // Transmissions that reached the maximum number of retries.
+        uint32_t Retries;            // Retries used by packets sent with 'send'.
+        uint32_t PacketsReceived;    // Data packets read from the RX FIFO buffer.
+        uint32_t AckPacketsReceived; // ACK packets read from the RX FIFO buffer.
+        uint16_t RxFifoFullEvents;   // Times the RX FIFO buffer was found full when starting a transmission.
+        uint16_t RxFifoFlushes;      // Times the RX FIFO buffer was cleared, losing any packets it contained.
+        uint16_t TxFifoFullEvents;   // Times the TX FIFO buffer was found full when starting a transmission.
+        uint16_t TxFifoFlushes;      // Times the TX FIFO buffer was cleared.
+        uint32_t SpiTransactions;
+        uint32_t SpiBytes;
+        uint32_t SpiBytesSaved;      // Bytes that were not transferred since the library remembered the register contents.
+        uint32_t WaitMicros;         // Time spent waiting on the radio, like for it to power up or complete a transmission.
+        uint32_t DataChecksSkipped;  // Calls to 'hasData' that returned without checking the radio, see 'getDataCheckInterval'.
+        uint32_t RxWaitMicros;       // For each data packet found by 'hasData', the time since the radio was last found
+                                     // without one, which is the longest it can have waited.  Divide by 'PacketsReceived'
+                                     // for the average.
+    };
+    #endif
+    
     // Methods for receivers and transmitters.
     // init      = Turns the radio on and puts it into receiving mode.  Returns 0 if it cannot communicate with the radio.
     //             Channel can be 0-125 and sets the exact frequency of the radio between 2400 - 2525 MHz.
+    //             'addressWidth' (3-5 bytes) and 'crcLength' (1-2 bytes) are sent with every packet.  Shorter values
+    //             suit small packets since they take less time to send.  'addressPrefix' holds the bytes between the
+    //             pipe number and radio id of every address, lowest byte first, with only 'addressWidth' - 2 of them
+    //             used.  Radios must use the same channel, bitrate, address width, CRC length, and prefix to talk to
+    //             each other.  Returns 0 for an address width or CRC length the radio does not support.
     // readData  = Loads a received data packet or ACK packet into the specified data parameter.
+    //             With 'maxLength', at most that many bytes are loaded and the rest of the packet is discarded.  It returns
+    //             the length of the packet, which can be compared with 'maxLength' to see if anything was discarded.
+    //             Given a variable rather than a pointer, it is loaded with the packet and 'sizeof' the variable is
+    //             used as 'maxLength'.  The variable must not be larger than 32 bytes, which is checked when compiling,
+    //             unless it is an array, which like a buffer may be larger than the packet.
+    //             Given a callback, each byte is passed to it as it is read so packets can be parsed without a buffer.
+    //             The callback runs in the middle of the SPI transfer, so it must be quick and cannot use the radio.
     // powerDown = Power down the radio.  It only draws 900 nA in this state.  The radio will be powered back on when one of the 
     //             'hasData' or 'send' methods is called.
     // printDetails = For debugging, it prints most radio registers using the serial object provided in the constructor.
-    uint8_t init(uint8_t radioId, uint8_t cePin, uint8_t csnPin, Bitrates bitrate = BITRATE2MBPS, uint8_t channel = 100); 
+    // resyncRegisters = The library remembers the configuration registers it has written so they are not re-sent or re-read
+    //                   over SPI.  If the radio may have lost its settings, like after a brown-out, this clears that memory so
+    //                   the registers are read from the radio again.
+    // setChannel = Changes the channel, 0-125.  Both radios of a link must use the same channel, see NRFLiteChannelChanger
+    //              for moving both of them.
+    // scanChannels = Listens on each channel 0-125 and stores in 'activity', which must hold 126 values, how many of
+    //                'samplesPerChannel' checks found another device transmitting, using the radio's received power
+    //                detector (RPD, above -64 dBm).  Takes around 'samplesPerChannel' * 22 ms, after which the radio
+    //                listens on its own channel again.  Needs separate CE and CSN pins:  with a shared pin, the SPI
+    //                transaction reading RPD also takes the radio out of RX mode, so the activity found is not reliable.
+    // getQuietestChannel = Scans the channels like 'scanChannels' and returns the one with the least activity.  Activity
+    //                      on the channels either side counts as well since Wi-Fi networks are 20 MHz wide.
+    // setSpiClock = Sets the SPI clock speed in Hz used with this radio, NRFLITE_SPI_CLOCK by default.  Can be called before
+    //               'init'.  Has no effect on the ATtiny84/85, whose USI transfers set their own speed.
+    // spiUsingInterrupt = Tells the library an interrupt handler uses the SPI bus, like one calling 'hasDataISR' or
+    //                     reading an SD card, given the number from 'digitalPinToInterrupt' for its pin.  That interrupt
+    //                     is then held off during the SPI transactions of every radio so it cannot corrupt one in progress.
+    //                     255 holds off all interrupts, which is what the ATtiny84/85 always do.
+    // getStats   = Returns a copy of the radio's counters, when NRFLITE_STATS is enabled.  The counters start at 0 after 'init'.
+    // resetStats = Sets the counters back to 0.  Both can be called with interrupts disabled on AVR, but other boards
+    //              enable interrupts when they finish, so there they must not be called with interrupts disabled.
+    // printTrace = Prints the recorded events, oldest first, using the serial object provided in the constructor and then
+    //              clears them.  Each line is the hex time, event type, and value.  extras/decode_trace.py turns this into
+    //              a timeline with latency histograms.  Requires NRFLITE_TRACE to be enabled.
+    uint8_t init(uint8_t radioId, uint8_t cePin, uint8_t csnPin, Bitrates bitrate = BITRATE2MBPS, uint8_t channel = 100,
+                 uint8_t addressWidth = 5, uint8_t crcLength = 1, uint32_t addressPrefix = 0x040302);
     void readData(void* data);
+    uint8_t readData(void* data, uint8_t maxLength);
+    template<typename T> typename NRFLiteEnableIf<!NRFLiteIsPointer<T>::value, uint8_t>::type readData(T& data);
+    uint8_t readData(ReceiveCallback callback);
     void powerDown();
     void printDetails();
+    void resyncRegisters();
+    void setChannel(uint8_t channel);
+    void scanChannels(uint8_t activity[126], uint8_t samplesPerChannel = 8);
+    uint8_t getQuietestChannel(uint8_t samplesPerChannel = 8);
+    void setSpiClock(uint32_t clock);
+    void spiUsingInterrupt(uint8_t interruptNumber);
+    #if NRFLITE_STATS
+    Stats getStats();
+    void resetStats();
+    #endif
+    #if NRFLITE_TRACE
+    void printTrace();
+    #endif
 
     // Methods for transmitters.
     // send       = Sends a data packet and waits for success or failure.  If NO_ACK is specified, no acknowledgment is required.
+    //              'toPipe' selects the pipe of a receiver using hub mode (1-5), and is normally left at 1.
+    //              The packet can be given as several segments, like a header and a sensor reading, which are sent one
+    //              after another in the same SPI transfer without first copying them into one buffer.  Bytes beyond
+    //              the 32 that fit in a packet are not sent.  Given a variable rather than a pointer and length, the
+    //              variable is sent.  It must not be larger than 32 bytes, which is checked when compiling.
     // hasAckData = Checks to see if an ACK data packet was received and returns its length.
-    uint8_t send(uint8_t toRadioId, void* data, uint8_t length, SendType sendType = REQUIRE_ACK);
+    // setRetries = Sets how long the radio waits for an ACK packet before sending a packet again, in 250 uS steps (1-16),
+    //              and how many times it sends it again (0-15).  'init' sets 2 steps at 2 and 1 Mbps, 6 steps at 250 Kbps,
+    //              and 15 retries, and has 'send' check on the radio every 250 uS at 2 Mbps, 1000 uS at 1 Mbps, and
+    //              1500 uS at 250 Kbps.  This sets the check to once per wait instead.  The wait must cover the
+    //              receiver sending back the ACK packet, or packets fail.
+    uint8_t send(uint8_t toRadioId, void* data, uint8_t length, SendType sendType = REQUIRE_ACK, uint8_t toPipe = 1);
+    uint8_t send(uint8_t toRadioId, const Segment* segments, uint8_t segmentCount, SendType sendType = REQUIRE_ACK, uint8_t toPipe = 1);
+    template<typename T> typename NRFLiteEnableIf<!NRFLiteIsPointer<T>::value, uint8_t>::type
+        send(uint8_t toRadioId, const T& data, SendType sendType = REQUIRE_ACK, uint8_t toPipe = 1);
     uint8_t hasAckData();
+    void setRetries(uint8_t retryDelaySteps, uint8_t retryCount);
 
     // Methods for receivers.
     // hasData    = Checks to see if a data packet has been received and returns its length.
     // addAckData = Queues an acknowledgment packet for sending back to a transmitter.  Whenever the transmitter sends the 
     //              next data packet, it will get this ACK packet back in the response.  The radio will store up to 3 ACK packets
     //              but you can clear this buffer if you like using the 'removeExistingAcks' parameter.
+    //              In hub mode, 'pipe' selects which pipe's transmitters will receive the ACK packet.
+    // enableHubMode = Listens on pipes 1-5 rather than only pipe 1, so one radio can receive from 5 groups of transmitters
+    //                 that each send to a different pipe.  Each pipe has its own auto-acknowledgment and ACK packets.
+    //                 Calling 'init' turns hub mode off.
+    // getRxPipe  = Returns the pipe of the data packet last found by 'hasData', which is the packet 'readData' will load.
+    // getDataCheckInterval = With CE and CSN sharing a pin, 'hasData' returns 0 without checking the radio if it was
+    //                        checked less than this many microseconds ago, since checking stops the radio receiving.
+    //                        It is shorter during bursts of packets of up to 7 bytes at 2 Mbps, or 3 bytes at 250 Kbps.
     uint8_t hasData(uint8_t usingInterrupts = 0);
-    void addAckData(void* data, uint8_t length, uint8_t removeExistingAcks = 0); 
+    void addAckData(void* data, uint8_t length, uint8_t removeExistingAcks = 0, uint8_t pipe = 1); 
+    void enableHubMode();
+    uint8_t getRxPipe();
+    uint16_t getDataCheckInterval();
     
     // Methods when using the radio's IRQ pin for interrupts.
-    // startSend    = Start sending a data packet without waiting for it to complete.
+    // startSend    = Start sending a data packet without waiting for it to complete.  It can be given segments like 'send'.
     // whatHappened = Use this inside the interrupt handler to see what caused the interrupt.
     // hasDataISR   = Same as hasData(1) and is just for clarity.  It will greatly speed up the receive bitrate when CE and CSN 
     //                share the same pins.
-    void startSend(uint8_t toRadioId, void* data, uint8_t length, SendType sendType = REQUIRE_ACK); 
+    void startSend(uint8_t toRadioId, void* data, uint8_t length, SendType sendType = REQUIRE_ACK, uint8_t toPipe = 1); 
+    void startSend(uint8_t toRadioId, const Segment* segments, uint8_t segmentCount, SendType sendType = REQUIRE_ACK, uint8_t toPipe = 1);
     void whatHappened(uint8_t& tx_ok, uint8_t& tx_fail, uint8_t& rx_ready); 
     uint8_t hasDataISR(); 
     
     private:
     
+    friend class NRFLiteStreamer;
+    friend class NRFLiteAsyncSender;
+    friend class NRFLiteLinkAdapter;
+    friend class NRFLiteChannelChanger;
+    friend class NRFLiteBeacon;
+    friend class NRFLiteTdmaReceiver;
+    friend class NRFLiteTdmaSender;
+    friend class NRFLiteBatchSender;
+    template<uint8_t PACKET_COUNT> friend class NRFLiteRxBuffer;
+    template<uint8_t PACKET_COUNT> friend class NRFLiteAckQueue;
+    template<uint8_t PACKET_COUNT> friend class NRFLiteTxQueue;
+    template<uint8_t ROUTE_COUNT, uint8_t PACKET_COUNT> friend class NRFLiteRouter;
+    
     enum SpiTransferType { READ_OPERATION, WRITE_OPERATION };
 
     Stream* _serial;
     uint8_t _cePin, _csnPin, _enableInterruptFlagsReset;
-    uint16_t _transmissionRetryWaitMicros, _allowedDataCheckIntervalMicros;
-    uint64_t _microsSinceLastDataCheck;
+    volatile uint8_t *_cePort, *_csnPort;  // Output port registers and bit masks for the CE and CSN pins,
+    uint8_t _ceMask, _csnMask;             // used on AVR to avoid the overhead of digitalWrite.
+    uint32_t _spiClock;
+    // Used by USI transfers, which hold off interrupts themselves.  The flag is shared by every radio, as
+    // 'SPI.usingInterrupt' is, since an interrupt handler using one radio can corrupt a transfer with another.
+    static uint8_t _spiUsesInterrupts;
+    uint8_t _spiSavedSREG;
+    uint8_t _registerCache[STATUS];        // Copies of the configuration registers, CONFIG through RF_SETUP.
+    uint8_t _registerCacheFlags;           // Bit per register in '_registerCache' that holds a valid copy.
+    uint8_t _txRadioId, _txPipe;           // Radio id and pipe last written to TX_ADDR and RX_ADDR_P0.
+    uint8_t _addressWidth;
+    uint8_t _addressPrefix[3];
+    uint8_t _rxPipe;
+    #if NRFLITE_STATS
+    Stats _stats;
+    #endif
+    #if NRFLITE_TRACE
+    struct TraceEvent { uint32_t Micros; uint8_t Type; uint8_t Value; };
+    TraceEvent _traceEvents[NRFLITE_TRACE_LENGTH];
+    uint16_t _traceNextEvent;              // Index in '_traceEvents' for the next event.
+    uint8_t _traceIsFull;                  // Set once events are being overwritten.
+    uint8_t _traceStatusFlags;             // Interrupt flags in the STATUS register when last recorded.
+    #endif
+    uint16_t _transmissionRetryWaitMicros;
+    uint16_t _frameMicros;                 // Airtime of a packet without data, and of each byte of data.
+    uint8_t _byteMicros;
+    uint16_t _dataCheckIntervalMicros;     // Used by 'hasData' when CE and CSN share a pin, see 'updateDataCheckInterval'.
+    uint16_t _allowedDataCheckIntervalMicros; // Tuned for 32 byte packets, see 'updateDataCheckInterval'.
+    uint8_t _shortPacketLength;            // Longest average length of packets checked for more often during a burst.
+    uint32_t _lastDataCheckMicros;
+    uint32_t _lastRxCheckMicros;           // Last check that found packets.
+    uint16_t _rxArrivalMicros;             // Average time between received packets.
+    uint8_t _rxLengthAverage;              // Average length of received packets.
+    uint8_t _rxPacketCount;                // Packets found since '_lastDataCheckMicros'.
+    uint8_t _isDrainingRx;                 // Set while 'hasData' is finding packets, so it checks again right away.
+    #if NRFLITE_STATS
+    uint32_t _rxEmptyMicros;               // When 'hasData' last found no packet.
+    #endif
+    uint32_t _powerUpMicros;               // When PWR_UP was last set, while '_isPoweringUp'.
+    uint8_t _isPoweringUp;
     
-    uint8_t getPipeOfFirstRxFifoPacket();
-    uint8_t getRxFifoPacketLength();
-    void prepForTransmission(uint8_t toRadioId, SendType sendType);
+    uint8_t getRxFifoPacketLength(uint8_t& pipe);
+    void updateDataCheckInterval();
+    uint8_t beginChannelScan();
+    void endChannelScan(uint8_t channel);
+    uint8_t sampleChannel(uint8_t channel, uint8_t samples);
+    void getAddress(uint8_t pipe, uint8_t radioId, uint8_t* address);
+    void forgetTxAddress();
+    uint16_t enterTxMode(uint8_t toRadioId, uint8_t toPipe = 1);
+    void prepForTransmission(uint8_t toRadioId, SendType sendType, uint8_t toPipe = 1);
+    uint8_t writeTxPayload(const Segment* segments, uint8_t segmentCount, SendType sendType);
     uint8_t readRegister(uint8_t regName);
     void readRegister(uint8_t regName, void* data, uint8_t length);
     void writeRegister(uint8_t regName, uint8_t data);
     void writeRegister(uint8_t regName, void* data, uint8_t length);
-    void spiTransfer(SpiTransferType transferType, uint8_t regName, void* data, uint8_t length);
-    uint8_t usiTransfer(uint8_t data);    
-    void printRegister(char* name, uint8_t regName);
+    uint16_t getPowerUpWaitMicros();
+    uint8_t readStatus();
+    void waitMicros(uint16_t microseconds);
+    #if NRFLITE_TRACE
+    void addTraceEvent(uint8_t type, uint8_t value);
+    #endif
+    uint8_t spiTransfer(SpiTransferType transferType, uint8_t regName, void* data, uint8_t length);
+    uint8_t spiBegin(uint8_t regName);
+    void spiEnd(uint8_t regName, uint8_t statusReg, uint8_t length);
+    void transportBegin();
+    void transportBeginTransaction();
+    void transportEndTransaction();
+    uint8_t transportTransfer(uint8_t data);
+    void transportPinMode(uint8_t pin, uint8_t mode);
+    void ceWrite(uint8_t level);
+    void csnWrite(uint8_t level);
+    uint8_t ceRead();
+    void printRegister(const char* name, uint8_t regName);
 };
 
+template<typename T>
+typename NRFLiteEnableIf<!NRFLiteIsPointer<T>::value, uint8_t>::type
+NRFLite::send(uint8_t toRadioId, const T& data, SendType sendType, uint8_t toPipe)
+{
+    static_assert(sizeof(T) <= 32, "NRFLite packets hold at most 32 bytes.");
+    Segment segment = { &data, sizeof(T) };
+    return send(toRadioId, &segment, 1, sendType, toPipe);
+}
+
+template<typename T>
+typename NRFLiteEnableIf<!NRFLiteIsPointer<T>::value, uint8_t>::type NRFLite::readData(T& data)
+{
+    static_assert(sizeof(T) <= 32 || NRFLiteIsArray<T>::value, "NRFLite packets hold at most 32 bytes.");
+    return readData(&data, sizeof(T));
+}
+
 #endif
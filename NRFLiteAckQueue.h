@@ -0,0 +1,159 @@
+#ifndef _NRFLiteAckQueue_h_
+#define _NRFLiteAckQueue_h_
+
+#include <NRFLite.h>
+
+// Holds ACK packets in RAM so a receiver can queue more than the 3 that fit in the radio's TX FIFO buffer, with a
+// queue for each pipe.  The radio sends an ACK packet to whichever transmitter next sends to its pipe, so to reach
+// particular transmitters, enable hub mode and have each of them send to its own pipe.
+// Read data packets with 'readData' of the queue rather than the radio so it knows when an ACK packet has gone out
+// and can load the next one.  The next one is loaded once every waiting data packet has been read, so a transmitter
+// sending again before then gets an empty ACK packet.  The radio holds one ACK packet for each of up to 3 pipes, so an
+// ACK packet for a pipe whose transmitters stop sending keeps one of those places until 'clear' is called.
+// PACKET_COUNT is the number of ACK packets that can be held (1 - 255), each using 35 bytes of RAM.
+// Meant for radios that only receive, since sending uses the same TX FIFO buffer.
+template<uint8_t PACKET_COUNT>
+class NRFLiteAckQueue {
+
+    public:
+
+    NRFLiteAckQueue(NRFLite& radio) : _radio(radio), _count(0), _latestOnlyPipes(0) {}
+
+    // add           = Queues an ACK packet for the transmitters sending to 'pipe' (1-5).  Returns 0 if the queue is full.
+    // setLatestOnly = Keeps only the newest ACK packet waiting for 'pipe', for data like a sensor reading where older
+    //                 values are of no use.  'add' then replaces the waiting packet rather than queuing another.
+    //                 A packet already loaded into the radio still goes out first.
+    // readData      = Same as the radio's 'readData'.  The ACK packet loaded for the pipe of the data packet went back
+    //                 with it, so the next one waiting for that pipe is loaded.
+    // dataReceived  = Tells the queue a data packet arrived on 'pipe', for programs that read packets without 'readData',
+    //                 like with NRFLiteRxBuffer.
+    // getCount      = Returns the number of ACK packets held for 'pipe', including one loaded into the radio.
+    // clear         = Removes all ACK packets, including those loaded into the radio.
+    uint8_t add(void* data, uint8_t length, uint8_t pipe = 1);
+    void setLatestOnly(uint8_t pipe, uint8_t latestOnly = 1);
+    void readData(void* data);
+    void dataReceived(uint8_t pipe);
+    uint8_t getCount(uint8_t pipe);
+    void clear();
+
+    private:
+
+    struct Packet { uint8_t Length; uint8_t Pipe; uint8_t IsLoaded; uint8_t Data[32]; };
+
+    NRFLite& _radio;
+    Packet _packets[PACKET_COUNT]; // Oldest first, so the packets for each pipe are in the order they were added.
+    uint8_t _count, _latestOnlyPipes;
+
+    void load();
+};
+
+template<uint8_t PACKET_COUNT>
+uint8_t NRFLiteAckQueue<PACKET_COUNT>::add(void* data, uint8_t length, uint8_t pipe)
+{
+    if (length > 32) { length = 32; }
+
+    Packet* packet = NULL;
+
+    if (_latestOnlyPipes & _BV(pipe)) {
+        for (uint8_t i = 0; i < _count; i++) {
+            if (_packets[i].Pipe == pipe && !_packets[i].IsLoaded) { packet = &_packets[i]; break; }
+        }
+    }
+
+    if (!packet) {
+        if (_count == PACKET_COUNT) { return 0; }
+        packet = &_packets[_count++];
+        packet->Pipe = pipe;
+        packet->IsLoaded = 0;
+    }
+
+    packet->Length = length;
+    memcpy(packet->Data, data, length);
+
+    load();
+    return 1;
+}
+
+template<uint8_t PACKET_COUNT>
+void NRFLiteAckQueue<PACKET_COUNT>::setLatestOnly(uint8_t pipe, uint8_t latestOnly)
+{
+    if (latestOnly) { _latestOnlyPipes |= _BV(pipe);  }
+    else            { _latestOnlyPipes &= ~_BV(pipe); }
+}
+
+template<uint8_t PACKET_COUNT>
+void NRFLiteAckQueue<PACKET_COUNT>::readData(void* data)
+{
+    _radio.readData(data);
+    dataReceived(_radio.getRxPipe());
+}
+
+template<uint8_t PACKET_COUNT>
+void NRFLiteAckQueue<PACKET_COUNT>::dataReceived(uint8_t pipe)
+{
+    for (uint8_t i = 0; i < _count; i++) {
+
+        if (_packets[i].Pipe != pipe || !_packets[i].IsLoaded) { continue; }
+
+        _count--;
+        for (uint8_t j = i; j < _count; j++) { _packets[j] = _packets[j + 1]; }
+        break;
+    }
+
+    load();
+}
+
+template<uint8_t PACKET_COUNT>
+uint8_t NRFLiteAckQueue<PACKET_COUNT>::getCount(uint8_t pipe)
+{
+    uint8_t count = 0;
+
+    for (uint8_t i = 0; i < _count; i++) {
+        if (_packets[i].Pipe == pipe) { count++; }
+    }
+
+    return count;
+}
+
+template<uint8_t PACKET_COUNT>
+void NRFLiteAckQueue<PACKET_COUNT>::clear()
+{
+    _radio.spiTransfer(NRFLite::WRITE_OPERATION, FLUSH_TX, NULL, 0);
+    _count = 0;
+}
+
+template<uint8_t PACKET_COUNT>
+void NRFLiteAckQueue<PACKET_COUNT>::load()
+{
+    // The radio sends the first ACK packet it holds for a pipe when a data packet arrives on that pipe.  We load only
+    // one per pipe, and only when no data packets are waiting to be read, so the next data packet read on a pipe is
+    // the one that carried its ACK packet.  A data packet that was already waiting would not have carried it, and if
+    // two arrive on a pipe before the first is read, the second went back with an empty ACK packet.
+    uint8_t loadedPipes = 0, loadedCount = 0;
+
+    for (uint8_t i = 0; i < _count; i++) {
+        if (_packets[i].IsLoaded) {
+            loadedPipes |= _BV(_packets[i].Pipe);
+            loadedCount++;
+        }
+    }
+
+    for (uint8_t i = 0; i < _count && loadedCount < 3; i++) {
+
+        Packet& packet = _packets[i];
+        if (packet.IsLoaded || (loadedPipes & _BV(packet.Pipe))) { continue; }
+
+        // A data packet that arrives while the ACK packet is being written is still taken to have carried it, leaving
+        // 2 for the pipe in the radio.  They go out in order, but we check the radio has room rather than only trusting
+        // 'loadedCount' since an ACK packet written to a full TX FIFO buffer is lost.
+        uint8_t fifoReg = _radio.readRegister(FIFO_STATUS);
+        if (!(fifoReg & _BV(RX_EMPTY)) || (fifoReg & _BV(FIFO_FULL))) { return; }
+
+        _radio.spiTransfer(NRFLite::WRITE_OPERATION, (W_ACK_PAYLOAD | packet.Pipe), packet.Data, packet.Length);
+        packet.IsLoaded = 1;
+        loadedPipes |= _BV(packet.Pipe);
+        loadedCount++;
+    }
+}
+
+#endif
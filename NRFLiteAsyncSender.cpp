@@ -0,0 +1,134 @@
+#include <NRFLiteAsyncSender.h>
+
+////////////////////
+// Public methods //
+////////////////////
+
+uint8_t NRFLiteAsyncSender::submit(uint8_t toRadioId, void* data, uint8_t length, NRFLite::SendType sendType, SendCallback callback)
+{
+    if (_state != IDLE) { return 0; }
+
+    if (length > 32) { length = 32; }
+    memcpy(_data, data, length);
+    _length = length;
+    _toRadioId = toRadioId;
+    _sendType = sendType;
+    _callback = callback;
+    _result = SEND_PENDING;
+
+    // Rather than waiting for the radio to power up or switch into TX mode, we'll note when it will be ready.
+    _nextStepMicros = micros() + _radio.enterTxMode(toRadioId);
+    _state = WAITING_FOR_RADIO;
+
+    poll(); // Start right away if the radio is already in TX mode.
+    return 1;
+}
+
+void NRFLiteAsyncSender::poll()
+{
+    if (_state == IDLE) { return; }
+
+    // Nothing to do until the radio is ready for the next step.
+    uint32_t currentMicros = micros();
+    if ((int32_t)(currentMicros - _nextStepMicros) < 0) { return; }
+
+    if (_state == WAITING_FOR_RADIO) {
+
+        // If RX FIFO buffer is full and we require an ACK, clear it so we can receive the ACK response.
+        uint8_t fifoReg = _radio.readRegister(FIFO_STATUS);
+        if (fifoReg & _BV(RX_FULL) && _sendType == NRFLite::REQUIRE_ACK) {
+            _radio.spiTransfer(NRFLite::WRITE_OPERATION, FLUSH_RX, NULL, 0);
+        }
+
+        // If TX FIFO buffer is full, we'll send the packets it contains before adding ours, just like 'send' does.
+        if (fifoReg & _BV(FIFO_FULL)) {
+            _state = EMPTYING_TX_FIFO;
+        }
+        else {
+            startTransmission();
+            return;
+        }
+    }
+
+    uint8_t statusReg = _radio.readStatus();
+
+    if (statusReg & _BV(TX_DS)) {
+        _radio.writeRegister(STATUS, _BV(TX_DS));                         // Clear TX success flag.
+        #if NRFLITE_STATS
+        _radio._stats.PacketsAcked++;
+        #endif
+        if (_state == SENDING) { finish(1); return; }
+    }
+    else if (statusReg & _BV(MAX_RT)) {
+        _radio.spiTransfer(NRFLite::WRITE_OPERATION, FLUSH_TX, NULL, 0); // Clear TX FIFO buffer.
+        _radio.writeRegister(STATUS, _BV(MAX_RT));                        // Clear flag which indicates max retries has been reached.
+        #if NRFLITE_STATS
+        _radio._stats.PacketsFailed++;
+        #endif
+        if (_state == SENDING) { finish(0); return; }
+    }
+    else if (_state == SENDING) {
+        _nextStepMicros = currentMicros + _radio._transmissionRetryWaitMicros; // Still sending, check again later.
+        return;
+    }
+
+    // Emptying the TX FIFO buffer, send its next packet unless it is now empty.
+    if (_radio.readRegister(FIFO_STATUS) & _BV(TX_EMPTY)) {
+        startTransmission();
+    }
+    else {
+        _radio.ceWrite(HIGH);
+        _radio.waitMicros(11); // 10 uS = Required CE time to initiate data transmission.
+        _radio.ceWrite(LOW);
+        _nextStepMicros = micros() + _radio._transmissionRetryWaitMicros;
+    }
+}
+
+uint8_t NRFLiteAsyncSender::isBusy()
+{
+    return _state != IDLE;
+}
+
+NRFLiteAsyncSender::SendResult NRFLiteAsyncSender::getResult()
+{
+    return _result;
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+void NRFLiteAsyncSender::startTransmission()
+{
+    // Clear any previously asserted TX success or max retries flags.
+    uint8_t statusReg = _radio.readStatus();
+    if (statusReg & _BV(TX_DS) || statusReg & _BV(MAX_RT)) {
+        _radio.writeRegister(STATUS, statusReg & (_BV(TX_DS) | _BV(MAX_RT)));
+    }
+
+    // Add data to the TX FIFO buffer, with or without an ACK request.
+    if (_sendType == NRFLite::NO_ACK) { _radio.spiTransfer(NRFLite::WRITE_OPERATION, W_TX_PAYLOAD_NO_ACK, _data, _length); }
+    else                              { _radio.spiTransfer(NRFLite::WRITE_OPERATION, W_TX_PAYLOAD       , _data, _length); }
+
+    // Start transmission.  If we use the same pin for CE and CSN, transmission started when data was loaded.
+    if (_radio._cePin != _radio._csnPin) {
+        _radio.ceWrite(HIGH);
+        _radio.waitMicros(11); // 10 uS = Required CE time to initiate data transmission.
+        _radio.ceWrite(LOW);
+    }
+
+    #if NRFLITE_STATS
+    _radio._stats.PacketsSent++;
+    #endif
+
+    _state = SENDING;
+    _nextStepMicros = micros() + _radio._transmissionRetryWaitMicros;
+}
+
+void NRFLiteAsyncSender::finish(uint8_t success)
+{
+    _state = IDLE;
+    _result = success ? SEND_SUCCEEDED : SEND_FAILED;
+
+    if (_callback) { _callback(_toRadioId, success); }
+}
@@ -0,0 +1,49 @@
+#ifndef _NRFLiteAsyncSender_h_
+#define _NRFLiteAsyncSender_h_
+
+#include <NRFLite.h>
+
+// Sends packets without blocking the calling program.
+// 'send' waits for the radio to power up or switch into TX mode and then for the packet to succeed or fail, which
+// can take over 20 ms at 250 Kbps.  Here 'submit' returns immediately and the calling program repeatedly calls 'poll'
+// from its loop.  Each call does a small amount of work, only once the radio is ready for it, and never waits.
+// This works without the radio's IRQ pin.  While a packet is being sent, no other radio methods should be called.
+class NRFLiteAsyncSender {
+
+    public:
+
+    typedef void (*SendCallback)(uint8_t toRadioId, uint8_t success);
+
+    enum SendResult { SEND_PENDING, SEND_SUCCEEDED, SEND_FAILED };
+
+    NRFLiteAsyncSender(NRFLite& radio) : _radio(radio), _state(IDLE), _result(SEND_SUCCEEDED) {}
+
+    // submit    = Starts sending a packet and returns immediately.  Returns 0 if a packet is already being sent.
+    //             The packet is copied so its data can be changed as soon as this returns.  The optional callback is
+    //             called from 'poll' when the packet succeeds or fails.
+    // poll      = Moves the send along.  Call this as often as possible, like on every pass through 'loop'.
+    // isBusy    = Returns 1 while a packet is being sent.
+    // getResult = Returns the result of the most recently submitted packet.
+    uint8_t submit(uint8_t toRadioId, void* data, uint8_t length, NRFLite::SendType sendType = NRFLite::REQUIRE_ACK, SendCallback callback = NULL);
+    void poll();
+    uint8_t isBusy();
+    SendResult getResult();
+
+    private:
+
+    enum States { IDLE, WAITING_FOR_RADIO, EMPTYING_TX_FIFO, SENDING };
+
+    NRFLite& _radio;
+    States _state;
+    SendResult _result;
+    SendCallback _callback;
+    NRFLite::SendType _sendType;
+    uint8_t _toRadioId, _length;
+    uint8_t _data[32];
+    uint32_t _nextStepMicros;
+
+    void startTransmission();
+    void finish(uint8_t success);
+};
+
+#endif
@@ -0,0 +1,104 @@
+#include <NRFLiteBatch.h>
+
+////////////////////
+// Public methods //
+////////////////////
+
+void NRFLiteBatchSender::begin(uint8_t toRadioId, uint16_t maxAgeMillis, NRFLite::SendType sendType, uint8_t sendWhenAwake)
+{
+    _toRadioId = toRadioId;
+    _maxAgeMillis = maxAgeMillis;
+    _sendType = sendType;
+    _sendWhenAwake = sendWhenAwake;
+    _length = 0;
+    _sampleCount = 0;
+}
+
+uint8_t NRFLiteBatchSender::add(void* data, uint8_t length)
+{
+    if (length == 0) { return 1; }
+    if (length > MAX_SAMPLE_LENGTH) { length = MAX_SAMPLE_LENGTH; }
+
+    uint8_t success = 1;
+    if (_length + 1 + length > 32) { success = flush(); }
+
+    if (_sampleCount == 0) { _firstSampleMillis = millis(); }
+
+    _batch[_length] = length;
+    memcpy(&_batch[_length + 1], data, length);
+    _length += 1 + length;
+    _sampleCount++;
+
+    // Any further sample would need at least 2 bytes.
+    if (_length > 30) { success &= flush(); }
+
+    return success;
+}
+
+uint8_t NRFLiteBatchSender::update()
+{
+    if (_sampleCount == 0) { return 1; }
+
+    if (millis() - _firstSampleMillis >= _maxAgeMillis || (_sendWhenAwake && isPoweredUp())) {
+        return flush();
+    }
+
+    return 1;
+}
+
+uint8_t NRFLiteBatchSender::flush()
+{
+    if (_sampleCount == 0) { return 1; }
+
+    uint8_t wasPoweredUp = isPoweredUp();
+    uint8_t success = _radio.send(_toRadioId, _batch, _length, _sendType);
+    if (!wasPoweredUp) { _radio.powerDown(); }
+
+    if (!success) { _failedCount++; }
+    _length = 0;
+    _sampleCount = 0;
+    return success;
+}
+
+uint8_t NRFLiteBatchSender::getSampleCount()
+{
+    return _sampleCount;
+}
+
+uint16_t NRFLiteBatchSender::getFailedCount()
+{
+    return _failedCount;
+}
+
+void NRFLiteBatchReader::begin(void* packet, uint8_t length)
+{
+    _packet = (const uint8_t*)packet;
+    _length = length;
+    _position = 0;
+}
+
+uint8_t NRFLiteBatchReader::read(void* data)
+{
+    if (_position >= _length) { return 0; }
+
+    // A length running past the end of the packet means it was not a batch, so nothing more is read from it.
+    uint8_t length = _packet[_position];
+    if (length == 0 || _position + 1 + length > _length) {
+        _position = _length;
+        return 0;
+    }
+
+    memcpy(data, &_packet[_position + 1], length);
+    _position += 1 + length;
+    return length;
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+uint8_t NRFLiteBatchSender::isPoweredUp()
+{
+    // CONFIG is held in the register cache so this needs no SPI transaction.
+    return (_radio.readRegister(CONFIG) & _BV(PWR_UP)) > 0;
+}
@@ -0,0 +1,76 @@
+#ifndef _NRFLiteBatch_h_
+#define _NRFLiteBatch_h_
+
+#include <NRFLite.h>
+
+// Packs many small samples into each packet so a sensor wakes its radio far less often.  Sending a 2 to 4 byte sample
+// on its own costs as much as sending a full packet, since the radio spends most of the time powering up, about 1.5 ms,
+// and waiting for the ACK packet, while the bytes themselves take a few uS.  Here the samples are held in a batch and
+// sent together, once the batch is full, once its oldest sample reaches a maximum age, or as soon as the radio is found
+// powered up for some other reason, such as the program having just sent or received a packet of its own, so the batch
+// shares that power up.  A radio that was powered down before a batch is sent is powered down again afterwards.
+// Each sample is stored as a length byte followed by its data, so samples of different lengths can share a batch and
+// up to 31 bytes fit in a packet.  The receiver unpacks the samples with NRFLiteBatchReader.
+
+class NRFLiteBatchSender {
+
+    public:
+
+    static const uint8_t MAX_SAMPLE_LENGTH = 31;
+
+    NRFLiteBatchSender(NRFLite& radio) : _radio(radio), _length(0), _sampleCount(0), _failedCount(0) {}
+
+    // begin          = Sends batches to 'toRadioId' with 'sendType'.  A batch is sent once its oldest sample is
+    //                  'maxAgeMillis' old, which bounds how late samples arrive.  With 'sendWhenAwake', 'update' sends the
+    //                  batch whenever it finds the radio powered up.  Programs that keep the radio powered up should turn
+    //                  this off, or every sample is sent on its own.
+    // add            = Adds a sample of 1 to 31 bytes.  The batch is sent first if the sample does not fit, and right
+    //                  away once it is full.  Returns 0 if one of these sends failed, losing the samples in it.
+    // update         = Sends the batch if it has reached its maximum age or the radio is powered up.  Call this often,
+    //                  like on every pass through 'loop', and right after using the radio for something else.  Returns 0
+    //                  if the send failed.
+    // flush          = Sends the batch now, such as before the program powers down the microcontroller.  Returns 0 if
+    //                  the send failed.
+    // getSampleCount = Returns the number of samples waiting to be sent.
+    // getFailedCount = Returns the number of batches that could not be sent.
+    void begin(uint8_t toRadioId, uint16_t maxAgeMillis, NRFLite::SendType sendType = NRFLite::REQUIRE_ACK, uint8_t sendWhenAwake = 1);
+    uint8_t add(void* data, uint8_t length);
+    uint8_t update();
+    uint8_t flush();
+    uint8_t getSampleCount();
+    uint16_t getFailedCount();
+
+    private:
+
+    NRFLite& _radio;
+    uint8_t _toRadioId;
+    uint16_t _maxAgeMillis;
+    NRFLite::SendType _sendType;
+    uint8_t _sendWhenAwake;
+    uint8_t _batch[32];
+    uint8_t _length, _sampleCount;
+    uint32_t _firstSampleMillis;   // When the oldest sample in the batch was added.
+    uint16_t _failedCount;
+
+    uint8_t isPoweredUp();
+};
+
+class NRFLiteBatchReader {
+
+    public:
+
+    NRFLiteBatchReader() : _length(0), _position(0) {}
+
+    // begin = Starts unpacking a batch received with NRFLite 'readData'.  The packet is not copied, so it must not be
+    //         changed until its samples have been read.
+    // read  = Loads the next sample into 'data' and returns its length, or 0 once every sample has been read.
+    void begin(void* packet, uint8_t length);
+    uint8_t read(void* data);
+
+    private:
+
+    const uint8_t* _packet;
+    uint8_t _length, _position;
+};
+
+#endif
@@ -0,0 +1,91 @@
+#include <NRFLiteBeacon.h>
+
+////////////////////
+// Public methods //
+////////////////////
+
+uint8_t NRFLiteBeacon::begin(uint8_t toRadioId, void* data, uint8_t length, uint8_t toPipe)
+{
+    if (_radio._cePin == _radio._csnPin) { return 0; }
+
+    _radio.waitMicros(_radio.enterTxMode(toRadioId, toPipe));
+
+    // Clear any previously asserted TX success or max retries flags.  Max retries would stop the radio from sending.
+    uint8_t statusReg = _radio.readStatus();
+    if (statusReg & _BV(TX_DS) || statusReg & _BV(MAX_RT)) {
+        _radio.writeRegister(STATUS, statusReg & (_BV(TX_DS) | _BV(MAX_RT)));
+    }
+
+    load(data, length);
+    _lastSendMicros = micros() - _sendMicros; // Allow the first 'send' right away.
+    _isActive = 1;
+    return 1;
+}
+
+void NRFLiteBeacon::setData(void* data, uint8_t length)
+{
+    if (!_isActive) { return; }
+    load(data, length);
+}
+
+uint8_t NRFLiteBeacon::send()
+{
+    if (!_isActive) { return 0; }
+
+    uint32_t currentMicros = micros();
+    if (currentMicros - _lastSendMicros < _sendMicros) { return 0; }
+
+    // The radio sends the packet it holds each time CE is pulsed and keeps it for the next time.
+    _radio.ceWrite(HIGH);
+    _radio.waitMicros(11); // 10 uS = Required CE time to initiate data transmission.
+    _radio.ceWrite(LOW);
+    _lastSendMicros = currentMicros;
+
+    #if NRFLITE_STATS
+    _radio._stats.PacketsSent++;
+    #endif
+
+    return 1;
+}
+
+uint8_t NRFLiteBeacon::update(uint32_t intervalMicros)
+{
+    if (micros() - _lastSendMicros < intervalMicros) { return 0; }
+    return send();
+}
+
+void NRFLiteBeacon::end()
+{
+    if (!_isActive) { return; }
+
+    uint32_t elapsedMicros = micros() - _lastSendMicros;
+    if (elapsedMicros < _sendMicros) { _radio.waitMicros(_sendMicros - elapsedMicros); }
+
+    _radio.spiTransfer(NRFLite::WRITE_OPERATION, FLUSH_TX, NULL, 0); // Clear TX FIFO buffer, which stops the reuse.
+    _radio.writeRegister(STATUS, _BV(TX_DS));                         // Clear TX success flag left by the beacons.
+    _isActive = 0;
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+void NRFLiteBeacon::load(void* data, uint8_t length)
+{
+    if (length > 32) { length = 32; }
+
+    // Reuse must not be turned on or off while a packet is being sent, so wait for the last beacon to finish.
+    if (_isActive) {
+        uint32_t elapsedMicros = micros() - _lastSendMicros;
+        if (elapsedMicros < _sendMicros) { _radio.waitMicros(_sendMicros - elapsedMicros); }
+    }
+
+    // Reuse lasts until the TX FIFO buffer is cleared or another packet is loaded.  Clearing it first leaves the new
+    // packet as the only one the radio holds, and REUSE_TX_PL then keeps it there after each transmission.
+    _radio.spiTransfer(NRFLite::WRITE_OPERATION, FLUSH_TX, NULL, 0);
+    _radio.spiTransfer(NRFLite::WRITE_OPERATION, W_TX_PAYLOAD_NO_ACK, data, length);
+    _radio.spiTransfer(NRFLite::WRITE_OPERATION, REUSE_TX_PL, NULL, 0);
+
+    // 130 uS to enter TX mode and the packet's airtime.
+    _sendMicros = 130 + _radio._frameMicros + length * _radio._byteMicros;
+}
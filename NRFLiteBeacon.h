@@ -0,0 +1,42 @@
+#ifndef _NRFLiteBeacon_h_
+#define _NRFLiteBeacon_h_
+
+#include <NRFLite.h>
+
+// Sends the same packet over and over without an ACK, like a node announcing itself or its latest reading.
+// 'send' loads the packet over SPI every time it is called.  Here it is loaded once and the radio is told to reuse it
+// (REUSE_TX_PL), so each beacon only pulses the CE pin, with no SPI transfer at all, until 'setData' swaps in a new one.
+// Requires separate CE and CSN pins, since with a shared pin CE stays HIGH and the radio would send the packet
+// continuously.  The radio's TX success flag is left set while beaconing, so its IRQ pin stays LOW, and no other
+// radio methods should be called until 'end'.
+class NRFLiteBeacon {
+
+    public:
+
+    NRFLiteBeacon(NRFLite& radio) : _radio(radio), _isActive(0) {}
+
+    // begin   = Loads the packet for sending to the specified radio.  Returns 0 if the CE and CSN pins are shared.
+    // setData = Replaces the packet, using 3 SPI transfers and 3 bytes more than its length.  Waits if the previous
+    //           packet is still being sent.
+    // send    = Sends the packet again.  Returns 0 without sending if the previous one is still being sent, which
+    //           takes 130 uS plus the packet's airtime, around 290 uS for 32 bytes at 2 Mbps.
+    // update  = Sends the packet once 'intervalMicros' have passed since the last one.  Call this as often as possible,
+    //           like on every pass through 'loop'.  Returns 1 when the packet was sent.
+    // end     = Removes the packet from the radio, after which the other radio methods can be used again.
+    uint8_t begin(uint8_t toRadioId, void* data, uint8_t length, uint8_t toPipe = 1);
+    void setData(void* data, uint8_t length);
+    uint8_t send();
+    uint8_t update(uint32_t intervalMicros);
+    void end();
+
+    private:
+
+    NRFLite& _radio;
+    uint8_t _isActive;
+    uint16_t _sendMicros;     // Time to send the loaded packet, which must pass before CE is pulsed again.
+    uint32_t _lastSendMicros;
+
+    void load(void* data, uint8_t length);
+};
+
+#endif
@@ -0,0 +1,118 @@
+#include <NRFLiteChannelChanger.h>
+
+const static uint8_t SIGNATURE[3] = { 0xC4, 0x4E, 0x52 };
+const static uint8_t CHANGE_PACKET_LENGTH = 5; // Signature, type, and channel.
+const static uint8_t MOVE_REQUEST = 1;
+const static uint8_t MOVE_CONFIRMATION = 2;
+const static uint8_t MOVE_COMPLETION = 3;
+const static uint16_t CONFIRMATION_MILLIS = 100;         // How long the starting radio tries to send each of the
+                                                         // confirmation and completion.
+const static uint16_t CONFIRMATION_TIMEOUT_MILLIS = 250; // How long the other radio waits for each of them.
+
+////////////////////////////////////
+// Methods for the starting radio //
+////////////////////////////////////
+
+uint8_t NRFLiteChannelChanger::moveToChannel(uint8_t toRadioId, uint8_t channel)
+{
+    uint8_t previousChannel = getChannel();
+    if (channel > 125) { channel = 125; }
+    if (channel == previousChannel) { return 1; }
+
+    uint8_t packet[CHANGE_PACKET_LENGTH] = { SIGNATURE[0], SIGNATURE[1], SIGNATURE[2], MOVE_REQUEST, channel };
+
+    if (!_radio.send(toRadioId, packet, CHANGE_PACKET_LENGTH)) { return 0; } // Both radios stay where they are.
+
+    _radio.setChannel(channel);
+
+    // If the request's acknowledgment was lost the other radio may not have moved, so we keep trying for a while.
+    if (!sendUntilAcked(toRadioId, packet, MOVE_CONFIRMATION)) {
+        _radio.setChannel(previousChannel);
+        return 0;
+    }
+
+    // The other radio has moved, but it cannot tell whether its acknowledgment of the confirmation arrived, so it
+    // waits for this before staying.
+    sendUntilAcked(toRadioId, packet, MOVE_COMPLETION);
+    return 1;
+}
+
+uint8_t NRFLiteChannelChanger::moveToQuietestChannel(uint8_t toRadioId, uint8_t samplesPerChannel)
+{
+    return moveToChannel(toRadioId, _radio.getQuietestChannel(samplesPerChannel));
+}
+
+uint8_t NRFLiteChannelChanger::getChannel()
+{
+    return _radio.readRegister(RF_CH);
+}
+
+/////////////////////////////////
+// Methods for the other radio //
+/////////////////////////////////
+
+uint8_t NRFLiteChannelChanger::hasData()
+{
+    // Go back if the starting radio did not confirm the move, or did not see it confirmed, since it will have gone
+    // back too.
+    if (_moveState != MOVE_DONE && millis() - _moveMillis > CONFIRMATION_TIMEOUT_MILLIS) {
+        _moveState = MOVE_DONE;
+        _radio.setChannel(_previousChannel);
+    }
+
+    if (_packetLength > 0) { return _packetLength; } // Not read yet.
+
+    uint8_t length;
+
+    while ((length = _radio.hasData()) > 0) {
+
+        _radio.readData(_packet);
+
+        uint8_t isChangePacket = length == CHANGE_PACKET_LENGTH && memcmp(_packet, SIGNATURE, sizeof(SIGNATURE)) == 0;
+
+        if (!isChangePacket) {
+            _packetLength = length;
+            return length;
+        }
+
+        uint8_t channel = _packet[4];
+
+        if (_packet[3] == MOVE_REQUEST && channel != getChannel()) {
+            _previousChannel = getChannel();
+            _radio.setChannel(channel);
+            _moveState = AWAITING_CONFIRMATION;
+            _moveMillis = millis();
+        }
+        else if (_packet[3] == MOVE_CONFIRMATION && channel == getChannel() && _moveState != MOVE_DONE) {
+            _moveState = AWAITING_COMPLETION;
+            _moveMillis = millis();
+        }
+        else if (_packet[3] == MOVE_COMPLETION && channel == getChannel()) {
+            _moveState = MOVE_DONE;
+        }
+    }
+
+    return 0;
+}
+
+void NRFLiteChannelChanger::readData(void* data)
+{
+    memcpy(data, _packet, _packetLength);
+    _packetLength = 0;
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+uint8_t NRFLiteChannelChanger::sendUntilAcked(uint8_t toRadioId, uint8_t* packet, uint8_t type)
+{
+    packet[3] = type;
+    uint32_t startMillis = millis();
+
+    do {
+        if (_radio.send(toRadioId, packet, CHANGE_PACKET_LENGTH)) { return 1; }
+    } while (millis() - startMillis < CONFIRMATION_MILLIS);
+
+    return 0;
+}
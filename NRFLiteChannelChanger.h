@@ -0,0 +1,52 @@
+#ifndef _NRFLiteChannelChanger_h_
+#define _NRFLiteChannelChanger_h_
+
+#include <NRFLite.h>
+
+// Moves both radios of a link to a new channel, like one with less Wi-Fi traffic found by 'getQuietestChannel'.
+// The radio starting the move sends the new channel to the other radio, and once it is acknowledged both change
+// channel.  The starting radio then sends a confirmation on the new channel.  If the confirmation is not acknowledged,
+// the starting radio returns to the original channel, and the other radio does the same when no confirmation arrives.
+// Since the other radio may receive the confirmation while its acknowledgments are lost, it only stays on the new
+// channel once a third packet, sent after the confirmation is acknowledged, shows the starting radio stayed too.
+// The radios end up on different channels only if every packet of the starting radio is lost for the 100 ms it
+// spends sending that third packet, in which case the other radio returns to the original channel alone.
+// The other radio must read its packets with this class rather than NRFLite so it can act on the channel change
+// packets, which are 5 bytes starting with 0xC4 0x4E 0x52.  Programs should not send packets matching that.
+class NRFLiteChannelChanger {
+
+    public:
+
+    NRFLiteChannelChanger(NRFLite& radio) : _radio(radio), _packetLength(0), _moveState(MOVE_DONE) {}
+
+    // Methods for the radio starting the move.
+    // moveToChannel         = Moves this radio and 'toRadioId' to the channel.  Returns 0 if the other radio could not be
+    //                         moved, in which case both remain on the current channel.
+    // moveToQuietestChannel = Same as 'moveToChannel' using the channel from 'getQuietestChannel'.
+    // getChannel            = Returns the current channel.
+    uint8_t moveToChannel(uint8_t toRadioId, uint8_t channel);
+    uint8_t moveToQuietestChannel(uint8_t toRadioId, uint8_t samplesPerChannel = 8);
+    uint8_t getChannel();
+
+    // Methods for the other radio.
+    // hasData  = Same as NRFLite 'hasData' but handles channel changes.  Call this often, like on every pass through 'loop',
+    //            so a move is followed quickly and undone if it is not confirmed.
+    // readData = Loads the data packet found by 'hasData'.
+    uint8_t hasData();
+    void readData(void* data);
+
+    private:
+
+    enum MoveStates { MOVE_DONE, AWAITING_CONFIRMATION, AWAITING_COMPLETION };
+
+    NRFLite& _radio;
+    uint8_t _packet[32];
+    uint8_t _packetLength;
+    MoveStates _moveState;
+    uint8_t _previousChannel;
+    uint32_t _moveMillis;      // When the other radio moved, or last received the confirmation.
+
+    uint8_t sendUntilAcked(uint8_t toRadioId, uint8_t* packet, uint8_t type);
+};
+
+#endif
@@ -0,0 +1,133 @@
+#include <NRFLiteLinkAdapter.h>
+
+const static uint8_t FULL_POWER_LEVEL = 3;
+const static uint8_t FAST_FAIL_RETRY_COUNT = 3;
+const static uint8_t POWER_REVIEW_INTERVAL = 16; // Packets sent to a destination between power level changes.
+const static uint8_t RAISE_POWER_RETRY_AVERAGE = 32; // Over 2 retries per packet.
+const static uint8_t LOWER_POWER_RETRY_AVERAGE = 4;  // Under 1/4 of a retry per packet.
+const static uint8_t LOWER_BITRATE_RETRY_AVERAGE = 64;
+
+////////////////////
+// Public methods //
+////////////////////
+
+uint8_t NRFLiteLinkAdapter::send(uint8_t toRadioId, void* data, uint8_t length, NRFLite::SendType sendType, uint8_t toPipe)
+{
+    Destination* destination = findDestination(toRadioId, 1);
+
+    // The retry delay must cover the receiver switching into TX mode (130 uS) and sending the ACK packet, timed with
+    // the airtimes found by NRFLite 'init'.  It is set in 250 uS steps, and we allow 10 uS for differences between the
+    // clocks of the 2 radios.
+    uint16_t ackMicros = 130 + _radio._frameMicros + _maxAckLength * _radio._byteMicros;
+    uint8_t retryDelaySteps = (ackMicros + 10 + 249) / 250;
+
+    // When packets to a destination keep failing it is likely turned off or out of range, so rather than using all
+    // 15 retries on each one we use a few to find out when it comes back.
+    uint8_t retryCount = destination->FailuresInARow >= 2 ? FAST_FAIL_RETRY_COUNT : 15;
+
+    // Unchanged settings are remembered by the library and not re-sent to the radio.  'setRetries' limits the settings
+    // and matches how often 'send' checks on the radio to the retry delay.
+    _radio.setRetries(retryDelaySteps, retryCount);
+    uint8_t rfSetupReg = _radio.readRegister(RF_SETUP) & ~(_BV(RF_PWR_LOW) | _BV(RF_PWR_HIGH));
+    _radio.writeRegister(RF_SETUP, rfSetupReg | (destination->PowerLevel << RF_PWR_LOW));
+
+    uint8_t success = _radio.send(toRadioId, data, length, sendType, toPipe);
+
+    if (sendType == NRFLite::NO_ACK) { return success; } // No retries to learn from.
+
+    // ARC_CNT holds the retries used by the packet.  A failed packet counts as 16 retries.
+    uint8_t retries = success ? _radio.readRegister(OBSERVE_TX) & 0x0F : 16;
+
+    // The average moves 1/8 of the way toward each new packet's retries, stored in 16ths of a retry.
+    uint16_t retryAverage = destination->RetryAverage - destination->RetryAverage / 8 + retries * 2;
+    destination->RetryAverage = retryAverage > 255 ? 255 : retryAverage;
+
+    if (success) {
+        destination->FailuresInARow = 0;
+    }
+    else {
+        if (destination->FailuresInARow < 255) { destination->FailuresInARow++; }
+        destination->PowerLevel = FULL_POWER_LEVEL; // Give a failing link every chance.
+    }
+
+    // Power level changes are based on a number of packets so one lost packet does not cause a change.
+    if (++destination->SendCount == POWER_REVIEW_INTERVAL) {
+        destination->SendCount = 0;
+
+        if (destination->RetryAverage > RAISE_POWER_RETRY_AVERAGE && destination->PowerLevel < FULL_POWER_LEVEL) {
+            destination->PowerLevel++;
+        }
+        else if (destination->RetryAverage < LOWER_POWER_RETRY_AVERAGE && destination->PowerLevel > 0) {
+            destination->PowerLevel--;
+        }
+    }
+
+    return success;
+}
+
+uint8_t NRFLiteLinkAdapter::getRetryAverage(uint8_t toRadioId)
+{
+    Destination* destination = findDestination(toRadioId, 0);
+    return destination ? destination->RetryAverage : 0;
+}
+
+NRFLite::Bitrates NRFLiteLinkAdapter::getRecommendedBitrate(uint8_t toRadioId)
+{
+    NRFLite::Bitrates bitrate = getBitrate();
+    Destination* destination = findDestination(toRadioId, 0);
+
+    if (destination == NULL) { return bitrate; }
+
+    // Lower bitrates have better receiver sensitivity, so they help once power can no longer be raised.
+    if (destination->PowerLevel == FULL_POWER_LEVEL && destination->RetryAverage > LOWER_BITRATE_RETRY_AVERAGE) {
+        if (bitrate == NRFLite::BITRATE2MBPS) { return NRFLite::BITRATE1MBPS; }
+        if (bitrate == NRFLite::BITRATE1MBPS) { return NRFLite::BITRATE250KBPS; }
+    }
+    else if (destination->PowerLevel == 0 && destination->RetryAverage < LOWER_POWER_RETRY_AVERAGE) {
+        if (bitrate == NRFLite::BITRATE250KBPS) { return NRFLite::BITRATE1MBPS; }
+        if (bitrate == NRFLite::BITRATE1MBPS)   { return NRFLite::BITRATE2MBPS; }
+    }
+
+    return bitrate;
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+NRFLiteLinkAdapter::Destination* NRFLiteLinkAdapter::findDestination(uint8_t radioId, uint8_t addIfMissing)
+{
+    for (uint8_t i = 0; i < _destinationCount; i++) {
+        if (_destinations[i].RadioId == radioId) { return &_destinations[i]; }
+    }
+
+    if (!addIfMissing) { return NULL; }
+
+    // Once all destinations are in use, they are replaced in turn.
+    Destination* destination;
+
+    if (_destinationCount < 4) {
+        destination = &_destinations[_destinationCount++];
+    }
+    else {
+        destination = &_destinations[_nextReplacement];
+        _nextReplacement = (_nextReplacement + 1) % 4;
+    }
+
+    destination->RadioId = radioId;
+    destination->RetryAverage = 0;
+    destination->PowerLevel = FULL_POWER_LEVEL;
+    destination->SendCount = 0;
+    destination->FailuresInARow = 0;
+
+    return destination;
+}
+
+NRFLite::Bitrates NRFLiteLinkAdapter::getBitrate()
+{
+    uint8_t rfSetupReg = _radio.readRegister(RF_SETUP);
+
+    if (rfSetupReg & _BV(RF_DR_LOW))  { return NRFLite::BITRATE250KBPS; }
+    if (rfSetupReg & _BV(RF_DR_HIGH)) { return NRFLite::BITRATE2MBPS; }
+    return NRFLite::BITRATE1MBPS;
+}
@@ -0,0 +1,53 @@
+#ifndef _NRFLiteLinkAdapter_h_
+#define _NRFLiteLinkAdapter_h_
+
+#include <NRFLite.h>
+
+// Adapts the retry settings and output power to each packet and destination radio.
+// 'init' uses one retry delay for every packet, long enough for the largest possible ACK packet, and always allows
+// 15 retries at full power.  Here the retry delay is sized from the longest ACK packet the program expects, and the
+// retries used by each packet are recorded per destination radio.  Output power is lowered on links that rarely need
+// retries and raised on links that do, and a destination whose packets keep failing gets fewer retries so its failures
+// are reported quickly.
+// The bitrate cannot be changed by the transmitter alone since the receiver only hears the bitrate it was
+// initialized with, so 'getRecommendedBitrate' provides one for the program to arrange with the receiver.
+// The settings chosen remain in effect for the other transmit methods.  Up to 4 destination radios are tracked.
+class NRFLiteLinkAdapter {
+
+    public:
+
+    NRFLiteLinkAdapter(NRFLite& radio, uint8_t maxAckLength = 32) :
+        _radio(radio), _maxAckLength(maxAckLength), _destinationCount(0), _nextReplacement(0) {}
+
+    // send                  = Same as NRFLite 'send' but with the retry settings and output power adapted to the packet
+    //                         and destination radio.
+    // getRetryAverage       = Returns the recent average retries per packet to the destination radio, in 16ths of a
+    //                         retry.  A failed packet counts as 16 retries.  Returns 0 if no packets have been sent to
+    //                         the radio.
+    // getRecommendedBitrate = Returns a lower bitrate when packets to the destination radio need many retries even at
+    //                         full power, and a higher bitrate when they rarely need retries at the lowest power.
+    uint8_t send(uint8_t toRadioId, void* data, uint8_t length,
+                 NRFLite::SendType sendType = NRFLite::REQUIRE_ACK, uint8_t toPipe = 1);
+    uint8_t getRetryAverage(uint8_t toRadioId);
+    NRFLite::Bitrates getRecommendedBitrate(uint8_t toRadioId);
+
+    private:
+
+    struct Destination {
+        uint8_t RadioId;
+        uint8_t RetryAverage;      // In 16ths of a retry.
+        uint8_t PowerLevel;        // RF_PWR value, 0 = -18 dBm to 3 = 0 dBm.
+        uint8_t SendCount;         // Packets sent since the power level was last considered.
+        uint8_t FailuresInARow;
+    };
+
+    NRFLite& _radio;
+    uint8_t _maxAckLength;
+    Destination _destinations[4];
+    uint8_t _destinationCount, _nextReplacement;
+
+    Destination* findDestination(uint8_t radioId, uint8_t addIfMissing);
+    NRFLite::Bitrates getBitrate();
+};
+
+#endif
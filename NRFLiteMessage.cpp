@@ -0,0 +1,247 @@
+#include <NRFLiteMessage.h>
+
+const static uint8_t HEADER_LENGTH = 3;
+const static uint8_t FRAGMENT_DATA_LENGTH = 32 - HEADER_LENGTH;
+const static uint8_t WINDOW_LENGTH = 32;           // Fragments tracked at a time, one bit each in a uint32_t.
+const static uint16_t LAST_FRAGMENT_FLAG = 0x8000; // Set in the fragment number of the last fragment.
+const static uint16_t OVERFLOW_FLAG = 0x8000;      // Set in the base fragment number of an ACK packet when the message
+                                                   // does not fit in the receiver's buffer.
+const static uint16_t MAX_MESSAGE_LENGTH = 32768;
+const static uint8_t ACK_LENGTH = 7;               // Message id, base fragment number, and 4 bytes of received bits.
+const static uint8_t MAX_FAILURES_IN_A_ROW = 16;
+
+//////////////////////////
+// NRFLiteMessageSender //
+//////////////////////////
+
+uint8_t NRFLiteMessageSender::sendMessage(uint8_t toRadioId, void* data, uint16_t length)
+{
+    if (length == 0) { return 1; } // Nothing to send, and 'receiveMessage' could not report an empty message anyway.
+    if (length > MAX_MESSAGE_LENGTH) { return 0; }
+
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(data);
+    uint16_t fragmentCount = (length + FRAGMENT_DATA_LENGTH - 1) / FRAGMENT_DATA_LENGTH;
+    uint32_t startMillis = millis();
+
+    _messageId++;
+
+    // The window starts at the first fragment that has not been received.  For each fragment in the window we track
+    // whether it has been received, or is in the TX FIFO buffer waiting for its result.  The numbers of the fragments
+    // waiting for results are kept in the order they were sent, since the streamer provides results in that order.
+    // A fragment the radio acknowledged may still have been dropped by the receiver, if it did not fit in its buffer.
+    // So the message is only complete once an ACK packet shows the receiver has every fragment.
+    uint16_t baseFragment = 0, confirmedFragment = 0;
+    uint32_t receivedBits = 0, sendingBits = 0;
+    uint16_t sendingFragments[16];
+    uint8_t firstSending = 0, sendingCount = 0;
+    uint8_t nextOffset = 0, failuresInARow = 0, isRejected = 0;
+
+    _streamer.begin(toRadioId);
+
+    while (confirmedFragment < fragmentCount) {
+
+        // Find the next fragment in the window that still needs to be sent, continuing from the last one we sent
+        // so failed fragments are retried after the others rather than immediately.
+        uint8_t windowLength = fragmentCount - baseFragment < WINDOW_LENGTH ? fragmentCount - baseFragment : WINDOW_LENGTH;
+        uint8_t foundFragment = 0;
+
+        if (sendingCount < 16) {
+            for (uint8_t i = 0; i < windowLength; i++) {
+                if (nextOffset >= windowLength) { nextOffset = 0; }
+                if (!((receivedBits | sendingBits) & (1UL << nextOffset))) { foundFragment = 1; break; }
+                nextOffset++;
+            }
+        }
+
+        // When every fragment has been acknowledged but the receiver has not yet confirmed them, the last one is sent
+        // again to collect its latest ACK packet.  The receiver ignores the repeat.
+        uint8_t isConfirming = !foundFragment && baseFragment == fragmentCount && sendingCount == 0;
+
+        if (foundFragment || isConfirming) {
+
+            uint16_t fragment = isConfirming ? fragmentCount - 1 : baseFragment + nextOffset;
+            uint16_t dataOffset = fragment * FRAGMENT_DATA_LENGTH;
+            uint8_t dataLength = length - dataOffset < FRAGMENT_DATA_LENGTH ? length - dataOffset : FRAGMENT_DATA_LENGTH;
+            uint16_t fragmentNumber = fragment == fragmentCount - 1 ? fragment | LAST_FRAGMENT_FLAG : fragment;
+
+            uint8_t packet[32];
+            packet[0] = _messageId;
+            packet[1] = fragmentNumber;
+            packet[2] = fragmentNumber >> 8;
+            memcpy(packet + HEADER_LENGTH, bytes + dataOffset, dataLength);
+
+            _streamer.write(packet, HEADER_LENGTH + dataLength);
+
+            sendingFragments[(firstSending + sendingCount) % 16] = fragment;
+            sendingCount++;
+
+            if (foundFragment) {
+                sendingBits |= 1UL << nextOffset;
+                nextOffset++;
+            }
+        }
+        else {
+            _streamer.update(); // Everything in the window is sent or waiting for a result.
+        }
+
+        // Apply the results of fragments that have completed.
+        while (_streamer.hasResult() && sendingCount > 0) {
+
+            uint8_t success = _streamer.readResult();
+            uint16_t fragment = sendingFragments[firstSending];
+            firstSending = (firstSending + 1) % 16;
+            sendingCount--;
+
+            if (success) { failuresInARow = 0; }
+            else         { failuresInARow++;    }
+
+            if (fragment >= baseFragment && fragment < baseFragment + WINDOW_LENGTH) {
+                uint32_t fragmentBit = 1UL << (fragment - baseFragment);
+                sendingBits &= ~fragmentBit;
+                if (success) { receivedBits |= fragmentBit; }
+            }
+        }
+
+        // The receiver's ACK packets list the fragments it has.  Reading them also keeps our RX FIFO buffer from filling,
+        // which would prevent further ACK packets from being received.
+        while (_radio.hasAckData()) {
+
+            uint8_t ack[32];
+            uint8_t ackLength = _radio.hasAckData();
+            _radio.readData(ack);
+
+            if (ackLength != ACK_LENGTH || ack[0] != _messageId) { continue; }
+
+            uint16_t ackBaseFragment = ack[1] | (ack[2] << 8);
+            if (ackBaseFragment & OVERFLOW_FLAG) { isRejected = 1; break; }
+            if (ackBaseFragment > confirmedFragment) { confirmedFragment = ackBaseFragment; }
+
+            uint32_t ackReceivedBits = ack[3] | ((uint32_t)ack[4] << 8) | ((uint32_t)ack[5] << 16) | ((uint32_t)ack[6] << 24);
+
+            // Every fragment before the receiver's base fragment has been received.
+            while (baseFragment < ackBaseFragment && baseFragment < fragmentCount) {
+                receivedBits >>= 1;
+                sendingBits >>= 1;
+                baseFragment++;
+                if (nextOffset > 0) { nextOffset--; }
+            }
+
+            // Line up the receiver's window with ours.
+            if (ackBaseFragment >= baseFragment) {
+                uint8_t shift = ackBaseFragment - baseFragment;
+                if (shift < WINDOW_LENGTH) { receivedBits |= ackReceivedBits << shift; }
+            }
+        }
+
+        // Slide the window past the fragments that have been received.
+        while ((receivedBits & 1) && baseFragment < fragmentCount) {
+            receivedBits >>= 1;
+            sendingBits >>= 1;
+            baseFragment++;
+            if (nextOffset > 0) { nextOffset--; }
+        }
+
+        if (isRejected || failuresInARow >= MAX_FAILURES_IN_A_ROW) {
+            _streamer.end();
+            _goodputBitsPerSecond = 0;
+            return 0;
+        }
+    }
+
+    _streamer.end();
+    while (_radio.hasAckData()) { uint8_t ack[32]; _radio.readData(ack); }
+
+    uint32_t elapsedMillis = millis() - startMillis;
+    if (elapsedMillis == 0) { elapsedMillis = 1; }
+    _goodputBitsPerSecond = (uint32_t)length * 8 * 1000 / elapsedMillis;
+
+    return 1;
+}
+
+uint32_t NRFLiteMessageSender::getGoodput()
+{
+    return _goodputBitsPerSecond;
+}
+
+////////////////////////////
+// NRFLiteMessageReceiver //
+////////////////////////////
+
+void NRFLiteMessageReceiver::begin(void* buffer, uint16_t maxLength)
+{
+    _buffer = reinterpret_cast<uint8_t*>(buffer);
+    _maxLength = maxLength;
+    _isStarted = 0;
+}
+
+uint16_t NRFLiteMessageReceiver::receiveMessage()
+{
+    uint8_t packetLength;
+
+    while ((packetLength = _radio.hasData()) > 0) {
+
+        uint8_t packet[32];
+        _radio.readData(packet);
+
+        if (packetLength < HEADER_LENGTH || _buffer == NULL) { continue; }
+
+        uint8_t messageId = packet[0];
+        uint16_t fragmentNumber = packet[1] | (packet[2] << 8);
+        uint16_t fragment = fragmentNumber & ~LAST_FRAGMENT_FLAG;
+
+        // A new message id means the previous message is done with.
+        if (!_isStarted || messageId != _messageId) {
+            _isStarted = 1;
+            _isComplete = 0;
+            _messageId = messageId;
+            _isOverflowed = 0;
+            _baseFragment = 0;
+            _lastFragment = 0xFFFF;
+            _receivedBits = 0;
+        }
+
+        // Fragment numbers go well past the 32 KB limit, so the offset is computed in 32 bits to avoid wrapping.
+        uint32_t dataOffset = (uint32_t)fragment * FRAGMENT_DATA_LENGTH;
+        uint8_t dataLength = packetLength - HEADER_LENGTH;
+
+        // The radio has already acknowledged the fragment, so one that does not fit in the buffer is reported in our ACK
+        // packets instead, and the message is never completed.
+        if (dataOffset + dataLength > MAX_MESSAGE_LENGTH || dataOffset + dataLength > _maxLength) {
+            _isOverflowed = 1;
+        }
+
+        // Store fragments within our window, ignoring ones we already have.
+        if (fragment >= _baseFragment && fragment < _baseFragment + WINDOW_LENGTH && !_isOverflowed) {
+
+            memcpy(_buffer + dataOffset, packet + HEADER_LENGTH, dataLength);
+            _receivedBits |= 1UL << (fragment - _baseFragment);
+
+            if (fragmentNumber & LAST_FRAGMENT_FLAG) {
+                _lastFragment = fragment;
+                _length = dataOffset + dataLength;
+            }
+
+            while (_receivedBits & 1) {
+                _receivedBits >>= 1;
+                _baseFragment++;
+            }
+        }
+
+        // Tell the sender which fragments we have in the ACK packet for its next fragment.  Only the latest is useful,
+        // so any ACK packets that have not yet gone out are removed.
+        uint16_t ackBaseFragment = _isOverflowed ? _baseFragment | OVERFLOW_FLAG : _baseFragment;
+        uint8_t ack[ACK_LENGTH] = {
+            _messageId,
+            (uint8_t)ackBaseFragment, (uint8_t)(ackBaseFragment >> 8),
+            (uint8_t)_receivedBits, (uint8_t)(_receivedBits >> 8), (uint8_t)(_receivedBits >> 16), (uint8_t)(_receivedBits >> 24) };
+        _radio.addAckData(ack, ACK_LENGTH, 1);
+
+        // Any fragments of the next message are left in the RX FIFO buffer so they don't overwrite this one.
+        if (!_isComplete && _lastFragment != 0xFFFF && _baseFragment > _lastFragment) {
+            _isComplete = 1;
+            return _length;
+        }
+    }
+
+    return 0;
+}
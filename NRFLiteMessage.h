@@ -0,0 +1,62 @@
+#ifndef _NRFLiteMessage_h_
+#define _NRFLiteMessage_h_
+
+#include <NRFLite.h>
+#include <NRFLiteStreamer.h>
+
+// Transfers messages larger than the 32 byte packet limit, up to 32 KB, by splitting them into fragments.
+// Each fragment has a 3 byte header, the message id followed by the fragment number, leaving 29 bytes of data.
+// The sender streams fragments through the radio's TX FIFO buffer with NRFLiteStreamer, working within a window of
+// 32 fragments.  Only fragments that fail are sent again.  The receiver also returns the fragments it has in every ACK
+// packet, so a fragment that arrived but whose acknowledgment was lost is not sent again.  A message only succeeds once
+// an ACK packet shows the receiver has every fragment, and one that does not fit in the receiver's buffer fails.
+// The receiver recognizes a new message by its 8 bit message id changing.  A sender that restarts numbers its messages
+// from the beginning again, so if its first message has the same id as the last message received, the receiver takes
+// its fragments to be repeats and ignores them.  Call 'begin' on the receiver again when the sender restarts.
+
+class NRFLiteMessageSender {
+
+    public:
+
+    NRFLiteMessageSender(NRFLite& radio) : _radio(radio), _streamer(radio), _messageId(0), _goodputBitsPerSecond(0) {}
+
+    // sendMessage = Sends the message and waits for it to be received.  Returns 0 if the message is longer than 32 KB,
+    //               does not fit in the receiver's buffer, or the receiver stopped responding.
+    // getGoodput  = Returns the bits per second of message data, not including headers or repeated fragments,
+    //               achieved by the last 'sendMessage'.
+    uint8_t sendMessage(uint8_t toRadioId, void* data, uint16_t length);
+    uint32_t getGoodput();
+
+    private:
+
+    NRFLite& _radio;
+    NRFLiteStreamer _streamer;
+    uint8_t _messageId;
+    uint32_t _goodputBitsPerSecond;
+};
+
+class NRFLiteMessageReceiver {
+
+    public:
+
+    NRFLiteMessageReceiver(NRFLite& radio) : _radio(radio), _buffer(NULL), _isStarted(0) {}
+
+    // begin          = Provides the buffer that messages are assembled in.  A message that doesn't fit is rejected.
+    //                  Calling it again forgets the last message, so the next fragment received starts a new one.
+    // receiveMessage = Reads any received fragments.  Call this as often as possible, like on every pass through 'loop'.
+    //                  Returns the length of the message when it has been completely received, otherwise 0.
+    //                  The buffer is reused when the first fragment of the next message arrives.
+    void begin(void* buffer, uint16_t maxLength);
+    uint16_t receiveMessage();
+
+    private:
+
+    NRFLite& _radio;
+    uint8_t* _buffer;
+    uint16_t _maxLength, _length;
+    uint16_t _baseFragment, _lastFragment; // All fragments before '_baseFragment' have been received.
+    uint32_t _receivedBits;                // Bit for each of the 32 fragments starting at '_baseFragment'.
+    uint8_t _messageId, _isStarted, _isComplete, _isOverflowed;
+};
+
+#endif
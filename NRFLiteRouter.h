@@ -0,0 +1,281 @@
+#ifndef _NRFLiteRouter_h_
+#define _NRFLiteRouter_h_
+
+#include <NRFLite.h>
+#include <NRFLiteAsyncSender.h>
+
+// Relays packets through other radios to reach radios that are out of range.  Every packet has a 5 byte header,
+// the radio id of the destination and of the radio that sent it first, a sequence number, the most hops it may take,
+// and the hops taken so far, leaving 27 bytes of data.  A radio receiving a packet for another radio holds it in a
+// small queue and sends it on to the next hop given by its routing table, or straight to the destination if there is
+// no route for it.  Each route has its own send type, so hops over reliable links can skip the ACK packet.
+// Packets already seen, by radio id and sequence number, are dropped, so a packet that arrives twice, such as after its
+// ACK packet was lost, or that comes back around a loop in the routes, is not delivered or sent on again.  Packets
+// are also dropped once they have taken their most hops, when the queue is full, or when a hop fails 4 times.
+// Packets are sent with NRFLiteAsyncSender so the program keeps running while they are sent.  Since the radio cannot
+// receive while it sends, packets arriving then are lost unless they are retried.  So each hop is sent with 3 automatic
+// retries rather than 15, and a packet that still fails stays at the front of the queue, with the radio listening, for
+// as long as the attempt took before it is sent again.  A relay retrying a lossy hop then still hears the packets sent
+// to it, rather than the radio before it using up its retries too, and so on down the chain.  Radios relaying on the
+// same channel often send at once, and radios whose packets collide retry after the same delay and collide again, so
+// the router adds 0 to 750 uS to the delay set by 'init' or NRFLite 'setRetries', in steps of 250 uS given by the
+// lowest 2 bits of its radio id, up to the longest delay of 4000 uS.  These retry settings are only used while the
+// router sends, and the program's own settings are put back once each send completes.
+// ROUTE_COUNT is the number of routes that can be held (1 - 255), each using 3 bytes of RAM, and PACKET_COUNT is the
+// number of packets that can wait to be sent (1 - 255), each using 33 bytes, in addition to about 120 bytes.  All
+// radios must send to each other with NRFLiteRouter.
+template<uint8_t ROUTE_COUNT, uint8_t PACKET_COUNT>
+class NRFLiteRouter {
+
+    public:
+
+    static const uint8_t MAX_DATA_LENGTH = 27;
+
+    NRFLiteRouter(NRFLite& radio, uint8_t radioId) :
+        _radio(radio), _sender(radio), _radioId(radioId), _routeCount(0), _count(0), _sequence(0),
+        _recentCount(0), _recentIndex(0), _savedRetrySetting(0), _savedRetryWaitMicros(0), _isSending(0), _attempts(0), _packetLength(0),
+        _droppedCount(0) {}
+
+    // addRoute        = Sends packets for 'toRadioId' through 'nextHopId' with 'sendType'.  A route that already exists
+    //                   is changed.  Returns 0 if the routing table is full.
+    // removeRoute     = Removes the route, so packets for 'toRadioId' are sent straight to it.
+    // send            = Queues a packet of up to 27 bytes for 'toRadioId', which is dropped after 'maxHops' hops.
+    //                   Returns 0 if the queue is full.  The packet is copied and is sent by 'hasData'.
+    // hasData         = Same as NRFLite 'hasData' but sends on packets for other radios and sends queued packets.  Call
+    //                   this as often as possible, like on every pass through 'loop'.  Returns the length of the data.
+    // readData        = Loads the data of the packet found by 'hasData', without the header.
+    // getFromRadioId  = Returns the radio id that sent the packet found by 'hasData'.
+    // getHopCount     = Returns the hops the packet found by 'hasData' took, 1 if it came straight from that radio.
+    // getCount        = Returns the number of packets waiting to be sent.
+    // getDroppedCount = Returns the number of packets that could not be sent on, from this radio or others.
+    uint8_t addRoute(uint8_t toRadioId, uint8_t nextHopId, NRFLite::SendType sendType = NRFLite::REQUIRE_ACK);
+    void removeRoute(uint8_t toRadioId);
+    uint8_t send(uint8_t toRadioId, void* data, uint8_t length, uint8_t maxHops = 8);
+    uint8_t hasData();
+    void readData(void* data);
+    uint8_t getFromRadioId();
+    uint8_t getHopCount();
+    uint8_t getCount();
+    uint16_t getDroppedCount();
+
+    private:
+
+    enum HeaderBytes { TO_RADIO_ID, FROM_RADIO_ID, SEQUENCE, MAX_HOPS, HOP_COUNT, HEADER_LENGTH };
+
+    static const uint8_t RECENT_COUNT = 8; // Packets remembered to find those already seen.
+    static const uint8_t RETRY_COUNT = 3;  // Automatic retries of each attempt to send a packet.
+    static const uint8_t MAX_ATTEMPTS = 4;
+
+    struct Route { uint8_t ToRadioId, NextHopId, SendType; };
+    struct Packet { uint8_t Length; uint8_t Data[32]; };
+
+    NRFLite& _radio;
+    NRFLiteAsyncSender _sender;
+    uint8_t _radioId;
+    Route _routes[ROUTE_COUNT];
+    uint8_t _routeCount;
+    Packet _packets[PACKET_COUNT]; // Oldest first.
+    uint8_t _count, _sequence;
+    uint8_t _recentFromIds[RECENT_COUNT], _recentSequences[RECENT_COUNT];
+    uint8_t _recentCount, _recentIndex;
+    uint8_t _savedRetrySetting;    // The program's SETUP_RETR and retry wait, put back after each send.
+    uint16_t _savedRetryWaitMicros;
+    uint8_t _isSending;
+    uint8_t _attempts;             // Failed attempts to send the packet at the front of the queue.
+    uint32_t _sendStartMicros;     // When the last attempt started.
+    uint32_t _failMicros;          // When the last attempt failed.
+    uint8_t _packet[32];
+    uint8_t _packetLength;         // Length of the packet in '_packet' including the header, 0 once it has been read.
+    uint16_t _droppedCount;
+
+    uint8_t isRepeat(uint8_t fromRadioId, uint8_t sequence);
+    int16_t findRoute(uint8_t toRadioId);
+    void sendNext();
+};
+
+template<uint8_t ROUTE_COUNT, uint8_t PACKET_COUNT>
+uint8_t NRFLiteRouter<ROUTE_COUNT, PACKET_COUNT>::addRoute(uint8_t toRadioId, uint8_t nextHopId, NRFLite::SendType sendType)
+{
+    int16_t index = findRoute(toRadioId);
+
+    if (index < 0) {
+        if (_routeCount == ROUTE_COUNT) { return 0; }
+        index = _routeCount++;
+    }
+
+    Route& route = _routes[index];
+    route.ToRadioId = toRadioId;
+    route.NextHopId = nextHopId;
+    route.SendType = sendType;
+    return 1;
+}
+
+template<uint8_t ROUTE_COUNT, uint8_t PACKET_COUNT>
+void NRFLiteRouter<ROUTE_COUNT, PACKET_COUNT>::removeRoute(uint8_t toRadioId)
+{
+    int16_t index = findRoute(toRadioId);
+    if (index < 0) { return; }
+
+    _routeCount--;
+    for (uint8_t i = index; i < _routeCount; i++) { _routes[i] = _routes[i + 1]; }
+}
+
+template<uint8_t ROUTE_COUNT, uint8_t PACKET_COUNT>
+uint8_t NRFLiteRouter<ROUTE_COUNT, PACKET_COUNT>::send(uint8_t toRadioId, void* data, uint8_t length, uint8_t maxHops)
+{
+    if (_count == PACKET_COUNT) { return 0; }
+    if (length > MAX_DATA_LENGTH) { length = MAX_DATA_LENGTH; }
+
+    Packet& packet = _packets[_count++];
+    packet.Length = HEADER_LENGTH + length;
+    packet.Data[TO_RADIO_ID] = toRadioId;
+    packet.Data[FROM_RADIO_ID] = _radioId;
+    packet.Data[SEQUENCE] = _sequence++;
+    packet.Data[MAX_HOPS] = maxHops;
+    packet.Data[HOP_COUNT] = 0;
+    memcpy(&packet.Data[HEADER_LENGTH], data, length);
+
+    isRepeat(_radioId, packet.Data[SEQUENCE]); // Remembered so it is dropped if it comes back.
+    return 1;
+}
+
+template<uint8_t ROUTE_COUNT, uint8_t PACKET_COUNT>
+uint8_t NRFLiteRouter<ROUTE_COUNT, PACKET_COUNT>::hasData()
+{
+    if (_packetLength > 0) { return _packetLength - HEADER_LENGTH; } // Not read yet.
+
+    // No other radio methods can be used until the packet being sent completes.
+    if (_isSending) {
+        _sender.poll();
+        if (_sender.isBusy()) { return 0; }
+
+        _isSending = 0;
+        _radio.writeRegister(SETUP_RETR, _savedRetrySetting);
+        _radio._transmissionRetryWaitMicros = _savedRetryWaitMicros;
+
+        if (_sender.getResult() == NRFLiteAsyncSender::SEND_FAILED && ++_attempts < MAX_ATTEMPTS) {
+            _failMicros = micros();
+        }
+        else {
+            if (_attempts == MAX_ATTEMPTS) { _droppedCount++; }
+            _attempts = 0;
+            _count--;
+            for (uint8_t i = 0; i < _count; i++) { _packets[i] = _packets[i + 1]; }
+        }
+    }
+
+    // Empty the RX FIFO buffer before sending, which would otherwise clear it if it is full.  'hasData' also puts the
+    // radio back into RX mode after a packet has been sent.
+    uint8_t packet[32], length;
+
+    while ((length = _radio.hasData()) > 0) {
+
+        _radio.readData(packet);
+        if (length < HEADER_LENGTH || isRepeat(packet[FROM_RADIO_ID], packet[SEQUENCE])) { continue; }
+
+        packet[HOP_COUNT]++;
+
+        if (packet[TO_RADIO_ID] == _radioId) {
+            memcpy(_packet, packet, length);
+            _packetLength = length;
+            return length - HEADER_LENGTH;
+        }
+
+        if (packet[HOP_COUNT] >= packet[MAX_HOPS] || _count == PACKET_COUNT) {
+            _droppedCount++;
+            continue;
+        }
+
+        Packet& queued = _packets[_count++];
+        queued.Length = length;
+        memcpy(queued.Data, packet, length);
+    }
+
+    // After a failed attempt the radio listens for as long as the attempt took.
+    if (_count > 0 && (_attempts == 0 || micros() - _failMicros >= _failMicros - _sendStartMicros)) { sendNext(); }
+    return 0;
+}
+
+template<uint8_t ROUTE_COUNT, uint8_t PACKET_COUNT>
+void NRFLiteRouter<ROUTE_COUNT, PACKET_COUNT>::readData(void* data)
+{
+    memcpy(data, &_packet[HEADER_LENGTH], _packetLength - HEADER_LENGTH);
+    _packetLength = 0;
+}
+
+template<uint8_t ROUTE_COUNT, uint8_t PACKET_COUNT>
+uint8_t NRFLiteRouter<ROUTE_COUNT, PACKET_COUNT>::getFromRadioId()
+{
+    return _packet[FROM_RADIO_ID];
+}
+
+template<uint8_t ROUTE_COUNT, uint8_t PACKET_COUNT>
+uint8_t NRFLiteRouter<ROUTE_COUNT, PACKET_COUNT>::getHopCount()
+{
+    return _packet[HOP_COUNT];
+}
+
+template<uint8_t ROUTE_COUNT, uint8_t PACKET_COUNT>
+uint8_t NRFLiteRouter<ROUTE_COUNT, PACKET_COUNT>::getCount()
+{
+    return _count;
+}
+
+template<uint8_t ROUTE_COUNT, uint8_t PACKET_COUNT>
+uint16_t NRFLiteRouter<ROUTE_COUNT, PACKET_COUNT>::getDroppedCount()
+{
+    return _droppedCount;
+}
+
+template<uint8_t ROUTE_COUNT, uint8_t PACKET_COUNT>
+uint8_t NRFLiteRouter<ROUTE_COUNT, PACKET_COUNT>::isRepeat(uint8_t fromRadioId, uint8_t sequence)
+{
+    for (uint8_t i = 0; i < _recentCount; i++) {
+        if (_recentFromIds[i] == fromRadioId && _recentSequences[i] == sequence) { return 1; }
+    }
+
+    // Not seen yet, so it replaces the oldest packet remembered.
+    _recentFromIds[_recentIndex] = fromRadioId;
+    _recentSequences[_recentIndex] = sequence;
+    _recentIndex = _recentIndex + 1 == RECENT_COUNT ? 0 : _recentIndex + 1;
+    if (_recentCount < RECENT_COUNT) { _recentCount++; }
+    return 0;
+}
+
+template<uint8_t ROUTE_COUNT, uint8_t PACKET_COUNT>
+int16_t NRFLiteRouter<ROUTE_COUNT, PACKET_COUNT>::findRoute(uint8_t toRadioId)
+{
+    for (uint8_t i = 0; i < _routeCount; i++) {
+        if (_routes[i].ToRadioId == toRadioId) { return i; }
+    }
+
+    return -1;
+}
+
+template<uint8_t ROUTE_COUNT, uint8_t PACKET_COUNT>
+void NRFLiteRouter<ROUTE_COUNT, PACKET_COUNT>::sendNext()
+{
+    // The program's settings are saved before the router's replace them, so the offset is always added to the
+    // program's delay.  Upper 4 bits are the delay in 250 uS steps, less 1, and lower 4 bits the retry count.
+    _savedRetrySetting = _radio.readRegister(SETUP_RETR);
+    _savedRetryWaitMicros = _radio._transmissionRetryWaitMicros;
+    _radio.setRetries((_savedRetrySetting >> ARD) + 1 + (_radioId & 3), RETRY_COUNT);
+
+    Packet& packet = _packets[0];
+    uint8_t toRadioId = packet.Data[TO_RADIO_ID];
+    int16_t index = findRoute(toRadioId);
+
+    if (index < 0) {
+        _sender.submit(toRadioId, packet.Data, packet.Length, NRFLite::REQUIRE_ACK);
+    }
+    else {
+        Route& route = _routes[index];
+        _sender.submit(route.NextHopId, packet.Data, packet.Length, (NRFLite::SendType)route.SendType);
+    }
+
+    // The packet stays in the queue until it is sent or its last attempt fails.
+    _isSending = 1;
+    _sendStartMicros = micros();
+}
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef _NRFLiteRxBuffer_h_
+#define _NRFLiteRxBuffer_h_
+
+#include <NRFLite.h>
+
+// Holds received packets in RAM so bursts of data do not overflow the radio's 3 packet RX FIFO buffer.
+// Call 'handleInterrupt' from the interrupt handler for the radio's IRQ pin.  It moves every packet out of the
+// RX FIFO buffer using as few SPI transactions as possible.  The rest of the program then uses 'peek' and 'pop'
+// to work with the packets where they are stored, without copying them.
+// PACKET_COUNT is the number of packets that can be held (1 - 127), each using 34 bytes of RAM.
+// The radio must be in RX mode, as it is after 'init' or a call to 'hasData'.  Transmitters that use interrupts
+// still need to use 'whatHappened' since only the data received flag is handled here.
+template<uint8_t PACKET_COUNT>
+class NRFLiteRxBuffer {
+
+    public:
+
+    struct Packet { uint8_t Length; uint8_t Pipe; uint8_t Data[32]; };
+
+    NRFLiteRxBuffer(NRFLite& radio) : _radio(radio), _writeCount(0), _readCount(0), _overrunCount(0) {}
+
+    // handleInterrupt = Moves all packets from the RX FIFO buffer into RAM and returns how many were added.
+    //                   If RAM is full, packets are dropped and counted as overruns.
+    // available       = Returns the number of packets held in RAM.
+    // peek            = Returns the oldest packet, or NULL if there are none.  It remains valid until 'pop' is called.
+    // pop             = Removes the oldest packet.
+    // getOverrunCount = Returns the number of packets dropped because RAM was full.  On AVR it can be called with
+    //                   interrupts disabled, but other boards enable interrupts when it finishes.
+    uint8_t handleInterrupt();
+    uint8_t available();
+    Packet* peek();
+    void pop();
+    uint16_t getOverrunCount();
+
+    private:
+
+    NRFLite& _radio;
+    Packet _packets[PACKET_COUNT];
+
+    // The interrupt handler only changes '_writeCount' and the rest of the program only changes '_readCount',
+    // so neither needs to disable interrupts.  They count up to twice PACKET_COUNT so a full buffer can be told
+    // apart from an empty one.
+    volatile uint8_t _writeCount, _readCount;
+    volatile uint16_t _overrunCount;
+
+    uint8_t nextCount(uint8_t count) { return count + 1 == PACKET_COUNT * 2 ? 0 : count + 1; }
+    Packet& packetAt(uint8_t count) { return _packets[count < PACKET_COUNT ? count : count - PACKET_COUNT]; }
+};
+
+template<uint8_t PACKET_COUNT>
+uint8_t NRFLiteRxBuffer<PACKET_COUNT>::handleInterrupt()
+{
+    // Clear the data received flag before emptying the RX FIFO buffer.  A packet that arrives after we read the last
+    // one will set it again and cause another interrupt, so no packet can be left behind.
+    _radio.writeRegister(STATUS, _BV(RX_DR));
+
+    uint8_t addedCount = 0;
+
+    while (1) {
+
+        // Reading the length also provides the pipe, or tells us the RX FIFO buffer is empty.
+        uint8_t pipe;
+        uint8_t length = _radio.getRxFifoPacketLength(pipe);
+
+        if (pipe > 5) { break; } // RX FIFO buffer is empty.
+
+        // A packet without data is removed here, or it would be found again on every pass.  An invalid packet has
+        // already been cleared along with the rest of the RX FIFO buffer, and reading the empty buffer does nothing.
+        if (length == 0) {
+            _radio.spiTransfer(NRFLite::READ_OPERATION, R_RX_PAYLOAD, NULL, 0);
+            continue;
+        }
+
+        if (available() == PACKET_COUNT) {
+            uint8_t discard[32];
+            _radio.spiTransfer(NRFLite::READ_OPERATION, R_RX_PAYLOAD, discard, length);
+            _overrunCount++;
+            continue;
+        }
+
+        // Read the packet directly into its place in RAM.
+        Packet& packet = packetAt(_writeCount);
+        packet.Length = length;
+        packet.Pipe = pipe;
+        _radio.spiTransfer(NRFLite::READ_OPERATION, R_RX_PAYLOAD, packet.Data, length);
+
+        _writeCount = nextCount(_writeCount);
+        addedCount++;
+    }
+
+    return addedCount;
+}
+
+template<uint8_t PACKET_COUNT>
+uint8_t NRFLiteRxBuffer<PACKET_COUNT>::available()
+{
+    uint8_t writeCount = _writeCount;
+    return writeCount >= _readCount ? writeCount - _readCount : writeCount + PACKET_COUNT * 2 - _readCount;
+}
+
+template<uint8_t PACKET_COUNT>
+typename NRFLiteRxBuffer<PACKET_COUNT>::Packet* NRFLiteRxBuffer<PACKET_COUNT>::peek()
+{
+    if (available() == 0) { return NULL; }
+    return &packetAt(_readCount);
+}
+
+template<uint8_t PACKET_COUNT>
+void NRFLiteRxBuffer<PACKET_COUNT>::pop()
+{
+    if (available() == 0) { return; }
+    _readCount = nextCount(_readCount);
+}
+
+template<uint8_t PACKET_COUNT>
+uint16_t NRFLiteRxBuffer<PACKET_COUNT>::getOverrunCount()
+{
+    // The 2 bytes of the count cannot be read in one step, so prevent the interrupt handler changing it part way through.
+    // As with 'getStats', AVR restores the interrupt state while other boards enable interrupts afterwards.
+    #if defined(__AVR__)
+    uint8_t oldSREG = SREG;
+    cli();
+    uint16_t overrunCount = _overrunCount;
+    SREG = oldSREG;
+    #else
+    noInterrupts();
+    uint16_t overrunCount = _overrunCount;
+    interrupts();
+    #endif
+    return overrunCount;
+}
+
+#endif
@@ -0,0 +1,190 @@
+#include <NRFLiteStreamer.h>
+
+////////////////////
+// Public methods //
+////////////////////
+
+void NRFLiteStreamer::begin(uint8_t toRadioId, NRFLite::SendType sendType)
+{
+    _sendType = sendType;
+    _firstPacket = 0;
+    _packetCount = 0;
+    _resultCount = 0;
+    _failedPacketCount = 0;
+
+    _radio.prepForTransmission(toRadioId, sendType);
+
+    // Packets left in the TX FIFO buffer, like ACK packets added while we were receiving, would be sent as part
+    // of the stream and confuse our packet tracking, so we start with it empty.  Any previously asserted TX success
+    // or max retries flags are cleared for the same reason.
+    _radio.spiTransfer(NRFLite::WRITE_OPERATION, FLUSH_TX, NULL, 0);
+    _radio.writeRegister(STATUS, _BV(TX_DS) | _BV(MAX_RT));
+
+    // Hold CE HIGH so the radio transmits packets as soon as they are loaded and waits in Standby-II mode, rather
+    // than Standby-I, when it runs out of packets.  If we use the same pin for CE and CSN, CE is already HIGH
+    // whenever we are not using the SPI bus.
+    if (_radio._cePin != _radio._csnPin) {
+        _radio.ceWrite(HIGH);
+    }
+}
+
+void NRFLiteStreamer::write(void* data, uint8_t length)
+{
+    // Wait for room in the TX FIFO buffer.
+    update();
+    while (_packetCount == 3) { waitForPacket(); update(); }
+
+    if (length > 32) { length = 32; }
+
+    uint8_t index = (_firstPacket + _packetCount) % 3;
+    memcpy(_packets[index], data, length);
+    _packetLengths[index] = length;
+    _packetCount++;
+
+    loadPacket(index);
+    if (_packetCount == 1) { _oldestDueMicros = micros() + getPacketMicros(index); }
+    #if NRFLITE_STATS
+    _radio._stats.PacketsSent++;
+    #endif
+}
+
+void NRFLiteStreamer::update()
+{
+    if (_packetCount == 0) { return; }
+
+    uint8_t statusReg = _radio.readStatus();
+
+    if (statusReg & _BV(TX_DS)) {
+        _radio.writeRegister(STATUS, _BV(TX_DS)); // Clear TX success flag.
+        completePacket(1);
+    }
+
+    if (statusReg & _BV(MAX_RT)) {
+
+        // The radio stops transmitting while MAX_RT is set, leaving the failed packet at the top of the TX FIFO buffer
+        // with the packets we queued behind it.  Packets ahead of it were sent, but if more than one completed before we
+        // cleared TX_DS we only counted one, so we need to know exactly how many packets remain.
+        // TX_FULL tells us if there are 3.  Otherwise there are 1 or 2, and loading a throwaway packet tells us which since
+        // the buffer then becomes full only if there were 2.  The throwaway packet cannot be sent while MAX_RT is set.
+        uint8_t remaining = 3;
+
+        if (!(statusReg & _BV(TX_FULL))) {
+            uint8_t throwaway = 0;
+            _radio.spiTransfer(NRFLite::WRITE_OPERATION, W_TX_PAYLOAD_NO_ACK, &throwaway, 1);
+        }
+
+        // Clear the TX FIFO buffer.  The STATUS register provided by FLUSH_TX is from before the buffer was cleared.
+        uint8_t flushStatusReg = _radio.spiTransfer(NRFLite::WRITE_OPERATION, FLUSH_TX, NULL, 0);
+
+        if (!(statusReg & _BV(TX_FULL))) {
+            remaining = (flushStatusReg & _BV(TX_FULL)) ? 2 : 1;
+        }
+
+        if (remaining > _packetCount) { remaining = _packetCount; }
+
+        while (_packetCount > remaining) { completePacket(1); }
+        completePacket(0);
+
+        // Reload the packets that were behind the failed one and clear the max retries flag so the radio continues.
+        for (uint8_t i = 0; i < _packetCount; i++) {
+            loadPacket((_firstPacket + i) % 3);
+        }
+        _oldestDueMicros = micros() + getPacketMicros(_firstPacket);
+
+        _radio.writeRegister(STATUS, _BV(MAX_RT));
+    }
+    else if (_packetCount == 3 && !(statusReg & _BV(TX_FULL))) {
+        completePacket(1); // A packet completed that we did not count due to TX_DS already being set.
+    }
+
+    // When the TX FIFO buffer is empty all packets were sent.  This catches any we did not count due to TX_DS already
+    // being set.  Since nothing is being sent, a TX_DS flag that was set after we read STATUS belongs to one of these
+    // packets and is cleared so it is not counted for the next one.
+    if (_packetCount > 0 && (_radio.readRegister(FIFO_STATUS) & _BV(TX_EMPTY))) {
+        while (_packetCount > 0) { completePacket(1); }
+        _radio.writeRegister(STATUS, _BV(TX_DS));
+    }
+}
+
+uint8_t NRFLiteStreamer::hasResult()
+{
+    return _resultCount;
+}
+
+uint8_t NRFLiteStreamer::readResult()
+{
+    if (_resultCount == 0) { return 0; }
+
+    uint8_t result = _results & 1;
+    _results >>= 1;
+    _resultCount--;
+    return result;
+}
+
+uint16_t NRFLiteStreamer::end()
+{
+    while (_packetCount > 0) { waitForPacket(); update(); }
+
+    // Put the radio back into Standby-I mode.
+    if (_radio._cePin != _radio._csnPin) {
+        _radio.ceWrite(LOW);
+    }
+
+    return _failedPacketCount;
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+void NRFLiteStreamer::loadPacket(uint8_t index)
+{
+    // Add data to the TX FIFO buffer, with or without an ACK request.
+    if (_sendType == NRFLite::NO_ACK) { _radio.spiTransfer(NRFLite::WRITE_OPERATION, W_TX_PAYLOAD_NO_ACK, _packets[index], _packetLengths[index]); }
+    else                              { _radio.spiTransfer(NRFLite::WRITE_OPERATION, W_TX_PAYLOAD       , _packets[index], _packetLengths[index]); }
+}
+
+uint16_t NRFLiteStreamer::getPacketMicros(uint8_t index)
+{
+    // 130 uS to enter TX mode and the packet's airtime, plus if an ACK is required, 130 uS for the receiver to enter
+    // TX mode and the airtime of an ACK packet without data.  No packet completes sooner.
+    uint16_t packetMicros = 130 + _radio._frameMicros + _packetLengths[index] * _radio._byteMicros;
+    if (_sendType == NRFLite::REQUIRE_ACK) { packetMicros += 130 + _radio._frameMicros; }
+    return packetMicros;
+}
+
+void NRFLiteStreamer::waitForPacket()
+{
+    // Rather than checking the radio continuously, wait until the oldest packet could have completed, and after that
+    // check 8 times per packet time.  The packets behind it keep the radio busy while we wait.
+    int32_t dueMicros = _oldestDueMicros - micros();
+    if (dueMicros > 0) { _radio.waitMicros(dueMicros); }
+    else               { _radio.waitMicros(getPacketMicros(_firstPacket) / 8); }
+}
+
+void NRFLiteStreamer::completePacket(uint8_t success)
+{
+    _firstPacket = (_firstPacket + 1) % 3;
+    _packetCount--;
+
+    // The next packet was sent right after this one, so it cannot complete sooner than a packet time after it.
+    if (_packetCount > 0) { _oldestDueMicros += getPacketMicros(_firstPacket); }
+
+    if (!success) { _failedPacketCount++; }
+
+    #if NRFLITE_STATS
+    if (success) { _radio._stats.PacketsAcked++;  }
+    else         { _radio._stats.PacketsFailed++; }
+    #endif
+
+    // Results are stored one bit each, oldest in bit 0.  When all 8 are used, the oldest is dropped.
+    if (_resultCount == 8) {
+        _results >>= 1;
+        _resultCount--;
+    }
+
+    if (success) { _results |= _BV(_resultCount); }
+    else         { _results &= ~_BV(_resultCount); }
+
+    _resultCount++;
+}
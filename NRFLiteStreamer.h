@@ -0,0 +1,54 @@
+#ifndef _NRFLiteStreamer_h_
+#define _NRFLiteStreamer_h_
+
+#include <NRFLite.h>
+
+// Sends a continuous stream of packets to one radio while keeping the radio's 3 packet TX FIFO buffer full.
+// 'send' loads a single packet and waits for it to complete, so the radio sits idle while the next one is loaded.
+// Here the radio stays in TX mode for the whole stream (Standby-II when it runs out of packets) and the next packet
+// is already waiting in the TX FIFO buffer when the current one completes.
+// Packets are copied so the TX FIFO buffer can be reloaded if one of them fails, which uses 100 bytes of RAM.
+// The stream only helps with separate CE and CSN pins.  When they share a pin, CE goes LOW for every SPI transaction,
+// so the radio cannot stay in TX mode while packets are loaded or checked, and with ACKs the stream is slower than a
+// loop of 'send' calls and uses about twice the SPI bytes per packet.
+class NRFLiteStreamer {
+
+    public:
+
+    NRFLiteStreamer(NRFLite& radio) : _radio(radio) {}
+
+    // begin      = Prepares the radio to stream packets to the specified radio.  If NO_ACK is specified, no acknowledgment
+    //              is required for any of the packets.
+    // write      = Adds a packet to the stream, waiting for room in the TX FIFO buffer if it is full.  The packet is copied
+    //              so its data can be changed as soon as this returns.  Only the first 32 bytes are sent.
+    // update     = Checks for packets that have completed.  'write' and 'end' call this but it can be called at other
+    //              times to get results sooner.
+    // hasResult  = Returns the number of packet results waiting to be read.  The last 8 are kept.
+    // readResult = Returns 1 if the oldest waiting packet was successfully sent, or 0 if it failed.  When a packet fails, the
+    //              packets behind it are still sent.
+    // end        = Waits for all packets to complete and ends the stream.  Returns the number of packets that failed.
+    void begin(uint8_t toRadioId, NRFLite::SendType sendType = NRFLite::REQUIRE_ACK);
+    void write(void* data, uint8_t length);
+    void update();
+    uint8_t hasResult();
+    uint8_t readResult();
+    uint16_t end();
+
+    private:
+
+    NRFLite& _radio;
+    NRFLite::SendType _sendType;
+    uint8_t _packets[3][32];    // Copies of the packets in the TX FIFO buffer, in the same order.
+    uint8_t _packetLengths[3];
+    uint8_t _firstPacket, _packetCount;
+    uint8_t _results, _resultCount;
+    uint16_t _failedPacketCount;
+    uint32_t _oldestDueMicros; // Soonest the oldest packet in the TX FIFO buffer could complete.
+
+    void loadPacket(uint8_t index);
+    uint16_t getPacketMicros(uint8_t index);
+    void waitForPacket();
+    void completePacket(uint8_t success);
+};
+
+#endif
@@ -0,0 +1,470 @@
+#include <NRFLiteTdma.h>
+
+const static uint8_t SIGNATURE[3] = { 0xC4, 0x54, 0x44 };
+const static uint8_t BEACON = 1;
+const static uint8_t JOIN_REQUEST = 2;
+const static uint8_t LEAVE_REQUEST = 3;
+const static uint8_t REQUEST_PACKET_LENGTH = 5; // Signature, type, and radio id of the node.
+const static uint8_t BEACON_HEADER_LENGTH = 10; // Signature, type, slot, guard, and beacon times, then the slot table.
+const static uint8_t NO_SLOT = 255;
+const static uint8_t MAX_MISSED_BEACONS = 3;    // Frames a node keeps its slot timing without hearing a beacon.
+
+//////////////////////////////
+// Methods for the receiver //
+//////////////////////////////
+
+void NRFLiteTdmaReceiver::begin(uint8_t slotCount, uint8_t maxLength)
+{
+    if (slotCount < 1) { slotCount = 1; }
+    if (slotCount > MAX_SLOTS) { slotCount = MAX_SLOTS; }
+    if (maxLength > 32) { maxLength = 32; }
+
+    uint8_t address[5];
+    _radio.readRegister(RX_ADDR_P1, address, _radio._addressWidth);
+    _radioId = address[_radio._addressWidth - 1];
+    _slotCount = slotCount;
+    memset(_nodeIds, _radioId, sizeof(_nodeIds));
+
+    // Nodes load their packet over SPI at the start of their slot, and time it from when they heard the beacon, so the
+    // guard time covers both.  With a shared CE and CSN pin it also covers reading the packet of the previous slot, since
+    // the radio only listens again 130 uS afterwards.  Each SPI byte takes 8 clock cycles and about as many between bytes.
+    _guardMicros = 130 + _radio._frameMicros;
+    if (_radio._cePin == _radio._csnPin) { _guardMicros += (maxLength + 8) * 16000000UL / _radio._spiClock; }
+
+    // Entering TX mode, the packet, entering RX mode for the ACK packet, the ACK packet, and the guard time.
+    _slotMicros = 260 + 2 * _radio._frameMicros + maxLength * _radio._byteMicros + _guardMicros;
+    _beaconMicros = 130 + _radio._frameMicros + (BEACON_HEADER_LENGTH + slotCount) * _radio._byteMicros;
+
+    sendBeacon();
+}
+
+uint8_t NRFLiteTdmaReceiver::addNode(uint8_t radioId)
+{
+    uint8_t freeSlot = NO_SLOT;
+
+    for (uint8_t i = 0; i < _slotCount; i++) {
+        if (_nodeIds[i] == radioId) { return 1; }
+        if (_nodeIds[i] == _radioId && freeSlot == NO_SLOT) { freeSlot = i; }
+    }
+
+    if (freeSlot == NO_SLOT || radioId == _radioId) { return 0; }
+
+    _nodeIds[freeSlot] = radioId; // Announced in the next beacon.
+    return 1;
+}
+
+void NRFLiteTdmaReceiver::removeNode(uint8_t radioId)
+{
+    for (uint8_t i = 0; i < _slotCount; i++) {
+        if (_nodeIds[i] == radioId) { _nodeIds[i] = _radioId; }
+    }
+}
+
+uint8_t NRFLiteTdmaReceiver::getNodeCount()
+{
+    uint8_t count = 0;
+
+    for (uint8_t i = 0; i < _slotCount; i++) {
+        if (_nodeIds[i] != _radioId) { count++; }
+    }
+
+    return count;
+}
+
+uint32_t NRFLiteTdmaReceiver::getFrameMicros()
+{
+    return _guardMicros + (uint32_t)_slotCount * _slotMicros + _beaconMicros;
+}
+
+uint8_t NRFLiteTdmaReceiver::hasData()
+{
+    if (_slotCount == 0) { return 0; }               // Not started.
+    if (_packetLength > 0) { return _packetLength; } // Not read yet.
+
+    uint8_t isSharedPin = _radio._cePin == _radio._csnPin;
+
+    while (1) {
+
+        // Each slot starts with its guard time, so the packet of a slot has arrived, and the ACK packet been sent, by
+        // the time the guard time of the next slot starts.
+        uint32_t elapsedMicros = micros() - _referenceMicros;
+        uint32_t receivedSlots = elapsedMicros / _slotMicros;
+        if (receivedSlots > _slotCount) { receivedSlots = _slotCount; }
+
+        // With a shared CE and CSN pin every check stops the radio from receiving, so it is only checked during the
+        // guard time after each slot, when its packet has arrived and the next one has not started, and again while it
+        // has packets.  'usingInterrupts' = 1 keeps 'hasData' from limiting the checks itself.
+        uint8_t length = 0;
+
+        if (!isSharedPin || _needsCheck || receivedSlots > _checkedSlots) {
+            _checkedSlots = receivedSlots;
+            length = _radio.hasData(1);
+        }
+
+        _needsCheck = length > 0;
+
+        if (length == 0) {
+            if (elapsedMicros < _guardMicros + _slotCount * (uint32_t)_slotMicros) { return 0; }
+            sendBeacon(); // The last slot has ended.
+            continue;
+        }
+
+        _radio.readData(_packet);
+
+        uint8_t isRequest = length == REQUEST_PACKET_LENGTH && memcmp(_packet, SIGNATURE, sizeof(SIGNATURE)) == 0;
+
+        if (!isRequest) {
+            _packetLength = length;
+            return length;
+        }
+
+        if (_packet[3] == JOIN_REQUEST) {
+            addNode(_packet[4]);
+        }
+        else if (_packet[3] == LEAVE_REQUEST) {
+            removeNode(_packet[4]);
+        }
+    }
+}
+
+void NRFLiteTdmaReceiver::readData(void* data)
+{
+    memcpy(data, _packet, _packetLength);
+    _packetLength = 0;
+}
+
+void NRFLiteTdmaReceiver::sendBeacon()
+{
+    uint8_t beacon[32] = {
+        SIGNATURE[0], SIGNATURE[1], SIGNATURE[2], BEACON,
+        (uint8_t)_slotMicros, (uint8_t)(_slotMicros >> 8),
+        (uint8_t)_guardMicros, (uint8_t)(_guardMicros >> 8),
+        (uint8_t)_beaconMicros, (uint8_t)(_beaconMicros >> 8)
+    };
+    memcpy(&beacon[BEACON_HEADER_LENGTH], _nodeIds, _slotCount);
+
+    // The beacon goes to pipe 0 of this radio's id, which nodes listen on while no radio uses it for its pipe 1, so no
+    // radio receives it as data.  Nodes learn the length of the frame from the time the previous beacon took to send.
+    uint32_t startMicros = micros();
+    _radio.send(_radioId, beacon, BEACON_HEADER_LENGTH + _slotCount, NRFLite::NO_ACK, 0);
+    _referenceMicros = micros();
+    _beaconMicros = _referenceMicros - startMicros;
+    _checkedSlots = 0;
+    _needsCheck = 1; // Start listening for the first slot.
+}
+
+///////////////////////////
+// Methods for the nodes //
+///////////////////////////
+
+uint8_t NRFLiteTdmaSender::begin(uint8_t toRadioId, uint8_t maxAttempts)
+{
+    if (_radio._cePin == _radio._csnPin) { return 0; }
+
+    uint8_t address[5];
+    _radio.readRegister(RX_ADDR_P1, address, _radio._addressWidth);
+    _radioId = address[_radio._addressWidth - 1];
+    _toRadioId = toRadioId;
+    _maxAttempts = maxAttempts > 0 ? maxAttempts : 1;
+    _radio.getAddress(0, toRadioId, _beaconAddress);
+
+    // Keep the time the radio waits for an ACK packet but send only once.  Upper 4 bits of SETUP_RETR are the delay in
+    // 250 uS steps, less 1.  The program's settings are put back by 'end'.
+    _retrySetting = _radio.readRegister(SETUP_RETR);
+    _retryWaitMicros = _radio._transmissionRetryWaitMicros;
+    _radio.setRetries((_retrySetting >> ARD) + 1, 0);
+
+    _randomState = (micros() ^ _radioId << 8) | 1; // Nodes joining together pick different free slots.
+    _isSynced = 0;
+    _slot = NO_SLOT;
+    _joinSlot = NO_SLOT;
+    _isSlotDone = 1;
+    _hasPacket = 0;
+    _isLoaded = 0;
+    _isSending = 0;
+    _result = SEND_SUCCEEDED;
+    _isActive = 1;
+
+    startListening();
+    return 1;
+}
+
+uint8_t NRFLiteTdmaSender::send(void* data, uint8_t length)
+{
+    if (!_isActive || _hasPacket) { return 0; }
+
+    if (length > 32) { length = 32; }
+    memcpy(_data, data, length);
+    _length = length;
+    _attempts = 0;
+    _hasPacket = 1;
+    _result = SEND_PENDING;
+    return 1;
+}
+
+void NRFLiteTdmaSender::update()
+{
+    if (!_isActive) { return; }
+
+    if (_isSending) {
+        if (micros() - _sendStartMicros < _sendMicros) { return; }
+
+        uint8_t statusReg = _radio.readStatus();
+        if (!(statusReg & (_BV(TX_DS) | _BV(MAX_RT)))) { return; }
+
+        finishSending(statusReg & _BV(TX_DS));
+        startListening();
+    }
+
+    uint32_t elapsedMicros = micros() - _referenceMicros;
+
+    // Look for the next beacon from a guard time before it is due until a guard time after.  When it is missed, the
+    // slots are timed from when it was due, for a few frames.
+    if (!_isSynced || elapsedMicros >= _periodMicros - _guardMicros) {
+
+        if (readBeacons()) { return; }
+
+        if (_isSynced && elapsedMicros >= _periodMicros + _guardMicros) {
+            _referenceMicros += _periodMicros;
+            _isSlotDone = 0;
+
+            if (++_missedBeacons > MAX_MISSED_BEACONS) {
+                _isSynced = 0;
+                _slot = NO_SLOT;
+            }
+
+            chooseJoinSlot();
+        }
+
+        return;
+    }
+
+    if (_isSlotDone) { return; }
+
+    uint8_t slot = _slot != NO_SLOT ? _slot : _joinSlot;
+    if (slot == NO_SLOT || (_slot != NO_SLOT && !_hasPacket)) { return; }
+
+    uint32_t slotStartMicros = _guardMicros + (uint32_t)slot * _slotMicros;
+    if (elapsedMicros < slotStartMicros) { return; }
+
+    // Once half the guard time has passed the packet could run into the next slot, so it waits for the next frame.
+    _isSlotDone = 1;
+    if (elapsedMicros - slotStartMicros < _guardMicros / 2) { startSending(); }
+}
+
+uint8_t NRFLiteTdmaSender::hasSlot()
+{
+    return _slot != NO_SLOT;
+}
+
+uint8_t NRFLiteTdmaSender::isBusy()
+{
+    return _hasPacket;
+}
+
+NRFLiteTdmaSender::SendResult NRFLiteTdmaSender::getResult()
+{
+    return _result;
+}
+
+void NRFLiteTdmaSender::end()
+{
+    if (!_isActive) { return; }
+
+    if (_hasPacket) { _result = SEND_FAILED; }
+
+    // The leave request is sent in the slot like any packet.
+    if (_slot != NO_SLOT) {
+
+        if (_isLoaded) { flushTx(); }
+
+        uint8_t request[REQUEST_PACKET_LENGTH] = { SIGNATURE[0], SIGNATURE[1], SIGNATURE[2], LEAVE_REQUEST, _radioId };
+        memcpy(_data, request, REQUEST_PACKET_LENGTH);
+        _length = REQUEST_PACKET_LENGTH;
+        _attempts = 0;
+        _hasPacket = 1;
+
+        uint32_t startMicros = micros();
+        uint32_t timeoutMicros = (_maxAttempts + 1UL) * _periodMicros;
+        while (_hasPacket && _slot != NO_SLOT && micros() - startMicros < timeoutMicros) { update(); }
+    }
+
+    while (_isSending && !(_radio.readStatus() & (_BV(TX_DS) | _BV(MAX_RT)))) {}
+    flushTx();
+    _radio.writeRegister(STATUS, _BV(TX_DS));
+    _radio.setRetries((_retrySetting >> ARD) + 1, _retrySetting & 0x0F);
+    _radio._transmissionRetryWaitMicros = _retryWaitMicros; // 'init' does not always set it from the delay.
+    _hasPacket = 0;
+    _isSending = 0;
+    _isActive = 0;
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+uint8_t NRFLiteTdmaSender::readBeacons()
+{
+    // Packets other than beacons are discarded, since the node only listens for beacons.
+    uint8_t isFound = 0;
+
+    while (1) {
+
+        uint8_t pipe, packet[32];
+        _radio.getRxFifoPacketLength(pipe);
+        if (pipe > 5) { break; }
+
+        uint8_t length = _radio.readData(packet, sizeof(packet));
+
+        uint8_t isBeacon = pipe == 0 && length > BEACON_HEADER_LENGTH &&
+                           memcmp(packet, SIGNATURE, sizeof(SIGNATURE)) == 0 && packet[3] == BEACON;
+
+        if (isBeacon) {
+            readBeacon(packet, length);
+            isFound = 1;
+        }
+    }
+
+    return isFound;
+}
+
+void NRFLiteTdmaSender::readBeacon(uint8_t* beacon, uint8_t length)
+{
+    _referenceMicros = micros();
+    _slotMicros = beacon[4] | beacon[5] << 8;
+    _guardMicros = beacon[6] | beacon[7] << 8;
+    uint16_t beaconMicros = beacon[8] | beacon[9] << 8;
+
+    _slotCount = length - BEACON_HEADER_LENGTH;
+    if (_slotCount > NRFLiteTdmaReceiver::MAX_SLOTS) { _slotCount = NRFLiteTdmaReceiver::MAX_SLOTS; }
+    memcpy(_slotIds, &beacon[BEACON_HEADER_LENGTH], _slotCount);
+    _periodMicros = _guardMicros + (uint32_t)_slotCount * _slotMicros + beaconMicros;
+
+    _slot = NO_SLOT;
+    for (uint8_t i = 0; i < _slotCount; i++) {
+        if (_slotIds[i] == _radioId) { _slot = i; }
+    }
+
+    _isSynced = 1;
+    _missedBeacons = 0;
+    _isSlotDone = 0;
+    chooseJoinSlot();
+}
+
+void NRFLiteTdmaSender::chooseJoinSlot()
+{
+    _joinSlot = NO_SLOT;
+    if (!_isSynced || _slot != NO_SLOT) { return; }
+
+    uint8_t freeSlots = 0;
+    for (uint8_t i = 0; i < _slotCount; i++) {
+        if (_slotIds[i] == _toRadioId) { freeSlots++; }
+    }
+
+    if (freeSlots == 0) { return; }
+
+    // xorshift
+    _randomState ^= _randomState << 7;
+    _randomState ^= _randomState >> 9;
+    _randomState ^= _randomState << 8;
+    uint8_t pick = _randomState % freeSlots;
+
+    for (uint8_t i = 0; i < _slotCount; i++) {
+        if (_slotIds[i] == _toRadioId && pick-- == 0) { _joinSlot = i; }
+    }
+}
+
+void NRFLiteTdmaSender::startSending()
+{
+    _radio.enterTxMode(_toRadioId); // Powered up already, since the radio has been listening.
+    _isJoining = _slot == NO_SLOT;
+
+    if (_isLoaded && !_isJoining) {
+        // The packet is still in the TX FIFO buffer from its last attempt, held back by the max retries flag, so it is
+        // sent again without loading it over SPI.  If only its ACK packet was lost the receiver gets it twice, since the
+        // radio only discards a packet matching the last one on the pipe, and the other nodes' packets come in between.
+        _radio.writeRegister(STATUS, _BV(MAX_RT));
+    }
+    else {
+        if (_isLoaded) { flushTx(); }
+
+        uint8_t statusReg = _radio.readStatus();
+        if (statusReg & _BV(TX_DS) || statusReg & _BV(MAX_RT)) {
+            _radio.writeRegister(STATUS, statusReg & (_BV(TX_DS) | _BV(MAX_RT)));
+        }
+
+        if (_isJoining) {
+            uint8_t request[REQUEST_PACKET_LENGTH] = { SIGNATURE[0], SIGNATURE[1], SIGNATURE[2], JOIN_REQUEST, _radioId };
+            _radio.spiTransfer(NRFLite::WRITE_OPERATION, W_TX_PAYLOAD, request, REQUEST_PACKET_LENGTH);
+        }
+        else {
+            _radio.spiTransfer(NRFLite::WRITE_OPERATION, W_TX_PAYLOAD, _data, _length);
+            _isLoaded = 1;
+        }
+    }
+
+    _radio.ceWrite(HIGH);
+    _radio.waitMicros(11); // 10 uS = Required CE time to initiate data transmission.
+    _radio.ceWrite(LOW);
+
+    #if NRFLITE_STATS
+    _radio._stats.PacketsSent++;
+    #endif
+
+    // The packet and its ACK packet take at least this long, so the radio is not checked before then.
+    uint8_t length = _isJoining ? REQUEST_PACKET_LENGTH : _length;
+    _sendMicros = 260 + 2 * _radio._frameMicros + length * _radio._byteMicros;
+    _sendStartMicros = micros();
+    _isSending = 1;
+}
+
+void NRFLiteTdmaSender::finishSending(uint8_t success)
+{
+    _isSending = 0;
+
+    if (success) {
+        _radio.writeRegister(STATUS, _BV(TX_DS));
+        #if NRFLITE_STATS
+        _radio._stats.PacketsAcked++;
+        #endif
+    }
+
+    if (_isJoining) {
+        if (!success) { flushTx(); } // Perhaps another node asked in the same slot.  The next beacon tells.
+        return;
+    }
+
+    if (success) {
+        _isLoaded = 0;
+        _hasPacket = 0;
+        _result = SEND_SUCCEEDED;
+    }
+    else if (++_attempts >= _maxAttempts) {
+        flushTx();
+        _hasPacket = 0;
+        _result = SEND_FAILED;
+        #if NRFLITE_STATS
+        _radio._stats.PacketsFailed++;
+        #endif
+    }
+}
+
+void NRFLiteTdmaSender::flushTx()
+{
+    _radio.spiTransfer(NRFLite::WRITE_OPERATION, FLUSH_TX, NULL, 0); // Clear TX FIFO buffer.
+    _radio.writeRegister(STATUS, _BV(MAX_RT));                        // Clear flag which indicates max retries has been reached.
+    _isLoaded = 0;
+}
+
+void NRFLiteTdmaSender::startListening()
+{
+    // Sending changed RX pipe 0 to the receiver's address for its ACK packet, so it is changed back to hear beacons, and
+    // the next 'send' or slot writes both addresses again.
+    _radio.writeRegister(RX_ADDR_P0, _beaconAddress, _radio._addressWidth);
+    _radio.forgetTxAddress();
+
+    uint8_t originalConfigReg = _radio.readRegister(CONFIG);
+    uint8_t newConfigReg = originalConfigReg | _BV(PWR_UP) | _BV(PRIM_RX);
+    if (originalConfigReg != newConfigReg) { _radio.writeRegister(CONFIG, newConfigReg); }
+    if (_radio.ceRead() == LOW) { _radio.ceWrite(HIGH); }
+}
@@ -0,0 +1,124 @@
+#ifndef _NRFLiteTdma_h_
+#define _NRFLiteTdma_h_
+
+#include <NRFLite.h>
+
+// Shares one receiver between many transmitting nodes by giving each node its own time slot.  Nodes that all 'send'
+// when they like collide more and more as their number grows, losing packets and retrying, until most of the airtime
+// is taken by collisions.  Here the receiver sends a beacon at the start of each frame, without an ACK, listing the node
+// assigned to each slot.  Nodes time their slots from when they hear the beacon and only send in their own, so packets
+// never overlap.  Each slot fits a packet, its ACK packet, and a guard time that is derived from the bitrate and covers
+// loading the packet over SPI and the nodes hearing the beacon at slightly different times.
+// A node without a slot asks for one by sending a join request in a free slot chosen at random, and the receiver gives
+// it the first free slot in the next beacon.  Slots are freed when nodes leave and are given to the next nodes to join.
+// The frame has a fixed number of slots, up to MAX_SLOTS, so free slots are airtime that goes unused.
+// The receiver must read its packets with NRFLiteTdmaReceiver so it can send the beacons and act on join and leave
+// requests, which are 5 bytes starting with 0xC4 0x54 0x44.  Programs should not send packets matching that.
+// Free slots are marked with the receiver's own radio id, which no node can have.  ACK packets from the receiver cannot
+// carry data, since a longer ACK packet would run into the next slot.
+// A packet whose ACK packet is lost is sent again in the next frame and reaches the receiver twice, so programs that must
+// not act on a packet twice should number their packets.
+
+class NRFLiteTdmaReceiver {
+
+    public:
+
+    static const uint8_t MAX_SLOTS = 22;
+
+    NRFLiteTdmaReceiver(NRFLite& radio) : _radio(radio), _slotCount(0), _packetLength(0) {}
+
+    // begin          = Starts sending beacons for a frame of 'slotCount' slots (1 - 22), each long enough for a packet
+    //                  of 'maxLength' bytes.
+    // addNode        = Gives the node a slot without it having to join, such as for nodes with fixed slots.  Returns 0 if
+    //                  every slot is taken.  A node that already has a slot keeps it.
+    // removeNode     = Frees the node's slot, such as when it has not been heard from for a while.
+    // getNodeCount   = Returns the number of nodes with a slot.
+    // getFrameMicros = Returns the time from one beacon to the next, the longest a node waits for its slot.
+    // hasData        = Same as NRFLite 'hasData' but sends the beacons and handles nodes joining and leaving.  Call this
+    //                  as often as possible, like on every pass through 'loop', since a late beacon delays every slot.
+    // readData       = Loads the data packet found by 'hasData'.
+    void begin(uint8_t slotCount, uint8_t maxLength = 32);
+    uint8_t addNode(uint8_t radioId);
+    void removeNode(uint8_t radioId);
+    uint8_t getNodeCount();
+    uint32_t getFrameMicros();
+    uint8_t hasData();
+    void readData(void* data);
+
+    private:
+
+    NRFLite& _radio;
+    uint8_t _radioId, _slotCount;
+    uint8_t _nodeIds[MAX_SLOTS];      // Radio id of the node in each slot, or '_radioId' when it is free.
+    uint16_t _slotMicros, _guardMicros;
+    uint16_t _beaconMicros;           // Time taken to send the last beacon.
+    uint32_t _referenceMicros;        // When the last beacon was sent, which the slots are timed from.
+    uint8_t _checkedSlots;            // Slots whose packets had arrived when the radio was last checked.
+    uint8_t _needsCheck;              // Set when the radio is to be checked right away, to drain it or start listening.
+    uint8_t _packet[32];
+    uint8_t _packetLength;
+
+    void sendBeacon();
+};
+
+class NRFLiteTdmaSender {
+
+    public:
+
+    enum SendResult { SEND_PENDING, SEND_SUCCEEDED, SEND_FAILED };
+
+    NRFLiteTdmaSender(NRFLite& radio) : _radio(radio), _isActive(0), _result(SEND_SUCCEEDED) {}
+
+    // begin     = Listens for the beacons of 'toRadioId' and joins its frame once one is heard.  A packet that is not
+    //             acknowledged is sent again in the next frame, for up to 'maxAttempts' frames.  Automatic retries are
+    //             turned off, since a retry would fall in the next node's slot.  Returns 0 if the CE and CSN pins are
+    //             shared, since the radio must keep listening for the beacon while its slot is being timed.
+    // send      = Queues a packet for the node's slot and returns immediately.  Returns 0 if a packet is already
+    //             waiting.  The packet is copied, and must be no longer than the 'maxLength' given to the receiver.
+    // update    = Listens for beacons and sends in the slot.  Call this as often as possible, like on every pass through
+    //             'loop', since a packet not sent within the first part of its slot waits for the next frame.
+    // hasSlot   = Returns 1 once the receiver has given this node a slot.
+    // isBusy    = Returns 1 while a packet is waiting to be sent.
+    // getResult = Returns the result of the most recently queued packet.
+    // end       = Gives the slot back to the receiver, waiting up to a few frames, and puts back the retry settings the
+    //             radio had before 'begin'.  A packet still waiting is dropped.  Other radio methods can be used again
+    //             afterwards.
+    uint8_t begin(uint8_t toRadioId, uint8_t maxAttempts = 4);
+    uint8_t send(void* data, uint8_t length);
+    void update();
+    uint8_t hasSlot();
+    uint8_t isBusy();
+    SendResult getResult();
+    void end();
+
+    private:
+
+    NRFLite& _radio;
+    uint8_t _isActive;
+    SendResult _result;
+    uint8_t _radioId, _toRadioId, _maxAttempts, _retrySetting;
+    uint16_t _retryWaitMicros;
+    uint8_t _beaconAddress[5];
+    uint8_t _slotIds[NRFLiteTdmaReceiver::MAX_SLOTS]; // Slot table from the last beacon.
+    uint8_t _slotCount, _slot, _joinSlot;
+    uint16_t _slotMicros, _guardMicros;
+    uint32_t _periodMicros;            // Time from one beacon to the next.
+    uint32_t _referenceMicros;         // When the last beacon was heard, or was due if it was missed.
+    uint8_t _isSynced, _missedBeacons, _isSlotDone;
+    uint8_t _hasPacket, _isLoaded, _isJoining, _isSending, _attempts;
+    uint8_t _data[32];
+    uint8_t _length;
+    uint16_t _sendMicros;
+    uint32_t _sendStartMicros;
+    uint16_t _randomState;
+
+    uint8_t readBeacons();
+    void readBeacon(uint8_t* beacon, uint8_t length);
+    void chooseJoinSlot();
+    void startSending();
+    void finishSending(uint8_t success);
+    void flushTx();
+    void startListening();
+};
+
+#endif
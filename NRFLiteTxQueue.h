@@ -0,0 +1,207 @@
+#ifndef _NRFLiteTxQueue_h_
+#define _NRFLiteTxQueue_h_
+
+#include <NRFLite.h>
+#include <NRFLiteStreamer.h>
+
+// Holds packets for any number of radios and sends them in batches, one destination at a time.  A gateway calling
+// 'send' for packets to many radios in turn sets the radio's address for each one, waits for each packet to complete,
+// and switches the radio back to RX mode whenever it checks for data in between.  Here all the packets waiting for a
+// radio go out together through the TX FIFO buffer like NRFLiteStreamer, and the radio stays in TX mode until the queue
+// is empty or the time given to 'update' runs out, after which it listens again.
+// The destination sent to next is that of the most urgent packet:  the highest priority, then the earliest deadline,
+// then the oldest.  Packets for the same radio follow in the same order.  Like NRFLiteStreamer, any ACK packets waiting
+// in the radio are cleared when a batch starts.
+// PACKET_COUNT is the number of packets that can be held (1 - 255), each using 41 bytes of RAM, in addition to the
+// 110 bytes of the stream.
+template<uint8_t PACKET_COUNT>
+class NRFLiteTxQueue {
+
+    public:
+
+    typedef void (*SendCallback)(uint8_t toRadioId, uint8_t success);
+
+    NRFLiteTxQueue(NRFLite& radio, SendCallback callback = NULL) :
+        _radio(radio), _streamer(radio), _callback(callback), _count(0) {}
+
+    // add      = Queues a packet for 'toRadioId'.  Packets with a higher 'priority' are sent first.  A packet with a
+    //            'deadlineMillis' that has not been sent within that many milliseconds is dropped and reported as failed.
+    //            Returns 0 if the queue is full.  The packet is copied so its data can be changed as soon as this returns.
+    // update   = Sends queued packets for up to 'maxMicros', or until the queue is empty if 0, then puts the radio back
+    //            into RX mode.  A batch in progress when the time runs out waits for the packets already loaded into the
+    //            radio.  The optional callback given to the constructor is called with the result of each packet.
+    //            Returns the number of packets that were successfully sent.
+    // getCount = Returns the number of packets waiting to be sent.
+    // clear    = Removes all waiting packets without reporting them.
+    uint8_t add(uint8_t toRadioId, void* data, uint8_t length, uint8_t priority = 0, uint16_t deadlineMillis = 0,
+                NRFLite::SendType sendType = NRFLite::REQUIRE_ACK);
+    uint8_t update(uint32_t maxMicros = 0);
+    uint8_t getCount();
+    void clear();
+
+    private:
+
+    struct Packet {
+        uint8_t ToRadioId, Priority, Length, HasDeadline, SendType;
+        uint32_t DeadlineMillis;
+        uint8_t Data[32];
+    };
+
+    NRFLite& _radio;
+    NRFLiteStreamer _streamer;
+    SendCallback _callback;
+    Packet _packets[PACKET_COUNT]; // Oldest first.
+    uint8_t _count;
+
+    int16_t findMostUrgent(uint8_t toRadioId, uint8_t anyRadio, NRFLite::SendType sendType);
+    void remove(uint8_t index);
+    void dropExpired();
+    uint8_t readResults(uint8_t toRadioId);
+};
+
+template<uint8_t PACKET_COUNT>
+uint8_t NRFLiteTxQueue<PACKET_COUNT>::add(uint8_t toRadioId, void* data, uint8_t length, uint8_t priority,
+                                          uint16_t deadlineMillis, NRFLite::SendType sendType)
+{
+    if (_count == PACKET_COUNT) { return 0; }
+    if (length > 32) { length = 32; }
+
+    Packet& packet = _packets[_count++];
+    packet.ToRadioId = toRadioId;
+    packet.Priority = priority;
+    packet.Length = length;
+    packet.HasDeadline = deadlineMillis > 0;
+    packet.DeadlineMillis = millis() + deadlineMillis;
+    packet.SendType = sendType;
+    memcpy(packet.Data, data, length);
+    return 1;
+}
+
+template<uint8_t PACKET_COUNT>
+uint8_t NRFLiteTxQueue<PACKET_COUNT>::update(uint32_t maxMicros)
+{
+    uint32_t startMicros = micros();
+    uint8_t successCount = 0, hasSent = 0;
+
+    while (1) {
+
+        dropExpired();
+        if (_count == 0 || (maxMicros && micros() - startMicros >= maxMicros)) { break; }
+
+        // Start a batch for the destination of the most urgent packet.  Packets sent with and without an ACK are sent
+        // in separate batches since the stream uses one type.
+        int16_t index = findMostUrgent(0, 1, NRFLite::REQUIRE_ACK);
+        uint8_t toRadioId = _packets[index].ToRadioId;
+        NRFLite::SendType sendType = (NRFLite::SendType)_packets[index].SendType;
+
+        _streamer.begin(toRadioId, sendType);
+        hasSent = 1;
+
+        while (index >= 0) {
+            Packet& packet = _packets[index];
+            _streamer.write(packet.Data, packet.Length);
+            remove(index);
+            successCount += readResults(toRadioId);
+
+            if (maxMicros && micros() - startMicros >= maxMicros) { break; }
+            dropExpired();
+            index = findMostUrgent(toRadioId, 0, sendType);
+        }
+
+        _streamer.end();
+        successCount += readResults(toRadioId);
+    }
+
+    // Start listening again.  This does not check for data with 'hasData', which would count a waiting packet as
+    // received before the program finds it.
+    if (hasSent) {
+        uint8_t originalConfigReg = _radio.readRegister(CONFIG);
+        uint8_t newConfigReg = originalConfigReg | _BV(PWR_UP) | _BV(PRIM_RX);
+        if (originalConfigReg != newConfigReg) { _radio.writeRegister(CONFIG, newConfigReg); }
+        if (_radio._cePin != _radio._csnPin && _radio.ceRead() == LOW) { _radio.ceWrite(HIGH); }
+    }
+
+    return successCount;
+}
+
+template<uint8_t PACKET_COUNT>
+uint8_t NRFLiteTxQueue<PACKET_COUNT>::getCount()
+{
+    return _count;
+}
+
+template<uint8_t PACKET_COUNT>
+void NRFLiteTxQueue<PACKET_COUNT>::clear()
+{
+    _count = 0;
+}
+
+template<uint8_t PACKET_COUNT>
+int16_t NRFLiteTxQueue<PACKET_COUNT>::findMostUrgent(uint8_t toRadioId, uint8_t anyRadio, NRFLite::SendType sendType)
+{
+    // Returns the index of the most urgent packet for the radio and send type, or for any radio, or -1 if there are none.
+    int16_t best = -1;
+
+    for (uint8_t i = 0; i < _count; i++) {
+
+        Packet& packet = _packets[i];
+        if (!anyRadio && (packet.ToRadioId != toRadioId || packet.SendType != sendType)) { continue; }
+        if (best < 0) { best = i; continue; }
+
+        // Packets are oldest first, so on a tie the packet already found is kept.
+        Packet& bestPacket = _packets[best];
+        if (packet.Priority != bestPacket.Priority) {
+            if (packet.Priority > bestPacket.Priority) { best = i; }
+        }
+        else if (packet.HasDeadline && (!bestPacket.HasDeadline ||
+                 (int32_t)(packet.DeadlineMillis - bestPacket.DeadlineMillis) < 0)) {
+            best = i;
+        }
+    }
+
+    return best;
+}
+
+template<uint8_t PACKET_COUNT>
+void NRFLiteTxQueue<PACKET_COUNT>::remove(uint8_t index)
+{
+    _count--;
+    for (uint8_t i = index; i < _count; i++) { _packets[i] = _packets[i + 1]; }
+}
+
+template<uint8_t PACKET_COUNT>
+void NRFLiteTxQueue<PACKET_COUNT>::dropExpired()
+{
+    uint32_t currentMillis = millis();
+
+    for (uint8_t i = 0; i < _count; ) {
+
+        Packet& packet = _packets[i];
+
+        if (packet.HasDeadline && (int32_t)(currentMillis - packet.DeadlineMillis) > 0) {
+            uint8_t toRadioId = packet.ToRadioId;
+            remove(i);
+            if (_callback) { _callback(toRadioId, 0); }
+        }
+        else {
+            i++;
+        }
+    }
+}
+
+template<uint8_t PACKET_COUNT>
+uint8_t NRFLiteTxQueue<PACKET_COUNT>::readResults(uint8_t toRadioId)
+{
+    // The stream reports results in the order packets were written, and all of them are for the batch's radio.
+    uint8_t successCount = 0;
+
+    while (_streamer.hasResult()) {
+        uint8_t success = _streamer.readResult();
+        successCount += success;
+        if (_callback) { _callback(toRadioId, success); }
+    }
+
+    return successCount;
+}
+
+#endif
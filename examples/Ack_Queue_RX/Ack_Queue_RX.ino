@@ -0,0 +1,62 @@
+/* Demonstrates NRFLiteAckQueue, which holds ACK packets in RAM for each pipe.  The receiver uses hub mode and each
+   transmitter sends to its own pipe, like in Basic_TX with the 'toPipe' parameter of 'send' set to 1-5, so commands
+   queued for a pipe only reach that transmitter.  Pipe 1 gets a queue of commands that all go out in order, while
+   pipe 2 only gets the latest reading of an analog pin.
+
+Radio -> Arduino
+
+CE    -> 9
+CSN   -> 10 (Hardware SPI SS)
+MOSI  -> 11 (Hardware SPI MOSI)
+MISO  -> 12 (Hardware SPI MISO)
+SCK   -> 13 (Hardware SPI SCK)
+IRQ   -> No connection in this example
+
+VCC   -> No more than 3.6 volts
+GND   -> GND
+
+*/
+
+#include <SPI.h>
+#include <NRFLite.h>
+#include <NRFLiteAckQueue.h>
+
+NRFLite _radio;
+NRFLiteAckQueue<10> _ackQueue(_radio); // Holds up to 10 ACK packets.
+uint8_t _nextCommand;
+uint32_t _lastQueueTime;
+
+void setup()
+{
+	Serial.begin(115200);
+	_radio.init(0, 9, 10); // radio id, CE pin, CSN pin
+	_radio.enableHubMode();
+	_ackQueue.setLatestOnly(2);
+}
+
+void loop()
+{
+	// Queue a few commands for the transmitter on pipe 1 every second.
+	if (millis() - _lastQueueTime > 999) {
+		_lastQueueTime = millis();
+
+		for (uint8_t i = 0; i < 4; i++) {
+			if (!_ackQueue.add(&_nextCommand, sizeof(_nextCommand), 1)) { Serial.println("Queue is full"); }
+			_nextCommand++;
+		}
+	}
+
+	while (_radio.hasData()) {
+
+		uint8_t data[32];
+		uint8_t pipe = _radio.getRxPipe();
+		_ackQueue.readData(data); // Use the queue to read so the next ACK packet for the pipe is loaded.
+
+		Serial.print("Received from pipe "); Serial.print(pipe);
+		Serial.print(", ACK packets waiting "); Serial.println(_ackQueue.getCount(pipe));
+	}
+
+	// Replaces the reading waiting for pipe 2 rather than queuing another.
+	uint16_t reading = analogRead(A0);
+	_ackQueue.add(&reading, sizeof(reading), 2);
+}
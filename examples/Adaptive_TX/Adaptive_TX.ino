@@ -0,0 +1,74 @@
+/* Demonstrates NRFLiteLinkAdapter, which adapts the retry settings and output power to each packet and destination.
+   Use with a receiver like Basic_RX.  The receiver does not send ACK packets, so the adapter is told to expect none,
+   allowing the shortest retry delay.
+
+Radio -> Arduino
+
+CE    -> 9
+CSN   -> 10 (Hardware SPI SS)
+MOSI  -> 11 (Hardware SPI MOSI)
+MISO  -> 12 (Hardware SPI MISO)
+SCK   -> 13 (Hardware SPI SCK)
+IRQ   -> No connection in this example
+
+VCC   -> No more than 3.6 volts
+GND   -> GND
+
+*/
+
+#include <SPI.h>
+#include <NRFLite.h>
+#include <NRFLiteLinkAdapter.h>
+
+const static uint8_t RADIO_ID             = 1;
+const static uint8_t DESTINATION_RADIO_ID = 0;
+const static uint8_t PIN_RADIO_CE         = 9;
+const static uint8_t PIN_RADIO_CSN        = 10;
+
+struct RadioPacket // Any packet up to 32 bytes can be sent.
+{
+	uint8_t FromRadioId;
+	uint32_t OnTimeMillis;
+	uint32_t FailedTxCount;
+};
+
+NRFLite _radio;
+NRFLiteLinkAdapter _adapter(_radio, 0); // 0 = Longest ACK packet the receiver will send.
+RadioPacket _radioData;
+
+void setup()
+{
+	Serial.begin(115200);
+	
+	if (!_radio.init(RADIO_ID, PIN_RADIO_CE, PIN_RADIO_CSN)) {
+		Serial.println("Cannot communicate with radio");
+		while (1) {} // Wait here forever.
+	}
+	
+	_radioData.FromRadioId = RADIO_ID;
+}
+
+void loop()
+{
+	_radioData.OnTimeMillis = millis();
+	
+	if (_adapter.send(DESTINATION_RADIO_ID, &_radioData, sizeof(_radioData))) {
+		Serial.print("Success");
+	}
+	else {
+		Serial.print("Failed");
+		_radioData.FailedTxCount++;
+	}
+	
+	// The average is in 16ths of a retry.
+	Serial.print(", average retries ");
+	Serial.print(_adapter.getRetryAverage(DESTINATION_RADIO_ID) / 16.0);
+	
+	if (_adapter.getRecommendedBitrate(DESTINATION_RADIO_ID) != NRFLite::BITRATE2MBPS) {
+		Serial.print(", a lower bitrate is recommended");
+	}
+	
+	Serial.println();
+	
+	delay(1000);
+}
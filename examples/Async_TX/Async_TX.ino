@@ -0,0 +1,51 @@
+/* Demonstrates sending without blocking by using NRFLiteAsyncSender.  The loop keeps running while the packet is sent,
+   so other work like reading sensors or serial input is not delayed.
+
+Radio -> Arduino
+
+CE    -> 9
+CSN   -> 10 (Hardware SPI SS)
+MOSI  -> 11 (Hardware SPI MOSI)
+MISO  -> 12 (Hardware SPI MISO)
+SCK   -> 13 (Hardware SPI SCK)
+IRQ   -> No connection in this example
+
+VCC   -> No more than 3.6 volts
+GND   -> GND
+
+*/
+
+#include <SPI.h>
+#include <NRFLite.h>
+#include <NRFLiteAsyncSender.h>
+
+NRFLite _radio;
+NRFLiteAsyncSender _sender(_radio);
+uint8_t _data;
+uint32_t _lastSendMillis, _loopCount;
+
+void setup()
+{
+	Serial.begin(115200);
+	_radio.init(1, 9, 10); // radio id, CE pin, CSN pin
+}
+
+void loop()
+{
+	_loopCount++;
+	_sender.poll(); // Keeps the send moving, never waits.
+	
+	if (millis() - _lastSendMillis > 999 && !_sender.isBusy()) {
+		_lastSendMillis = millis();
+		_data++;
+		_sender.submit(0, &_data, sizeof(_data), NRFLite::REQUIRE_ACK, sendComplete); // send _data to radio id 0
+	}
+}
+
+void sendComplete(uint8_t toRadioId, uint8_t success)
+{
+	Serial.print("Send "); Serial.print(_data);
+	Serial.print(success ? "...Success" : "...Failed");
+	Serial.print(", loops run since last result "); Serial.println(_loopCount);
+	_loopCount = 0;
+}
@@ -0,0 +1,64 @@
+/* Demonstrates NRFLiteBatchReader, which unpacks the samples batched by Batch_TX.  Batches arrive on pipe 1 and status
+   packets on pipe 2, so hub mode is turned on.
+
+Radio -> Arduino
+
+CE    -> 9
+CSN   -> 10 (Hardware SPI SS)
+MOSI  -> 11 (Hardware SPI MOSI)
+MISO  -> 12 (Hardware SPI MISO)
+SCK   -> 13 (Hardware SPI SCK)
+IRQ   -> No connection in this example
+
+VCC   -> No more than 3.6 volts
+GND   -> GND
+
+*/
+
+#include <SPI.h>
+#include <NRFLite.h>
+#include <NRFLiteBatch.h>
+
+const static uint8_t RADIO_ID = 0;
+const static uint8_t STATUS_PIPE = 2;
+
+struct StatusPacket
+{
+	uint32_t OnTimeMillis;
+	uint16_t FailedBatchCount;
+};
+
+NRFLite _radio;
+NRFLiteBatchReader _batchReader;
+uint8_t _packet[32];
+
+void setup()
+{
+	Serial.begin(115200);
+	_radio.init(RADIO_ID, 9, 10); // radio id, CE pin, CSN pin
+	_radio.enableHubMode();
+}
+
+void loop()
+{
+	uint8_t length;
+
+	while ((length = _radio.hasData()) > 0) {
+		uint8_t pipe = _radio.getRxPipe();
+		_radio.readData(_packet);
+
+		if (pipe == STATUS_PIPE) {
+			StatusPacket status;
+			memcpy(&status, _packet, sizeof(status));
+			Serial.print("Status, time "); Serial.print(status.OnTimeMillis);
+			Serial.print(", failed batches "); Serial.println(status.FailedBatchCount);
+			continue;
+		}
+
+		uint16_t reading;
+		Serial.print("Batch");
+		_batchReader.begin(_packet, length);
+		while (_batchReader.read(&reading)) { Serial.print(" "); Serial.print(reading); }
+		Serial.println();
+	}
+}
@@ -0,0 +1,67 @@
+/* Demonstrates NRFLiteBatchSender, which packs many small samples into each packet so the radio is powered up far less
+   often.  A 2 byte reading of pin A0 is taken every 100 milliseconds and sent to Batch_RX in batches of up to 10, at
+   least once a second.  A status packet is also sent every 10 seconds, and the batch goes along with it since the radio
+   is already powered up.  The radio is powered down the rest of the time.
+
+Radio -> Arduino
+
+CE    -> 9
+CSN   -> 10 (Hardware SPI SS)
+MOSI  -> 11 (Hardware SPI MOSI)
+MISO  -> 12 (Hardware SPI MISO)
+SCK   -> 13 (Hardware SPI SCK)
+IRQ   -> No connection in this example
+
+VCC   -> No more than 3.6 volts
+GND   -> GND
+
+*/
+
+#include <SPI.h>
+#include <NRFLite.h>
+#include <NRFLiteBatch.h>
+
+const static uint8_t RADIO_ID = 1;             // Our radio's id.
+const static uint8_t DESTINATION_RADIO_ID = 0; // Id of the radio running Batch_RX.
+const static uint8_t STATUS_PIPE = 2;          // Batch_RX receives batches on pipe 1 and status packets on pipe 2.
+
+struct StatusPacket
+{
+	uint32_t OnTimeMillis;
+	uint16_t FailedBatchCount;
+};
+
+NRFLite _radio;
+NRFLiteBatchSender _batchSender(_radio);
+StatusPacket _status;
+uint32_t _lastSampleMillis, _lastStatusMillis;
+
+void setup()
+{
+	Serial.begin(115200);
+	_radio.init(RADIO_ID, 9, 10); // radio id, CE pin, CSN pin
+	_radio.powerDown();
+
+	_batchSender.begin(DESTINATION_RADIO_ID, 1000); // Samples are sent within 1 second.
+}
+
+void loop()
+{
+	if (millis() - _lastSampleMillis > 99) {
+		_lastSampleMillis = millis();
+		uint16_t reading = analogRead(A0);
+		_batchSender.add(&reading, sizeof(reading));
+	}
+
+	if (millis() - _lastStatusMillis > 9999) {
+		_lastStatusMillis = millis();
+		_status.OnTimeMillis = millis();
+		_status.FailedBatchCount = _batchSender.getFailedCount();
+		_radio.send(DESTINATION_RADIO_ID, &_status, sizeof(_status), NRFLite::REQUIRE_ACK, STATUS_PIPE);
+
+		_batchSender.update(); // Finds the radio powered up so sends the batch now.
+		_radio.powerDown();
+	}
+
+	_batchSender.update(); // Sends the batch once it is 1 second old, so it is called on every pass.
+}
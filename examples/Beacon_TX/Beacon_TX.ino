@@ -0,0 +1,48 @@
+/* Demonstrates NRFLiteBeacon, which sends the same packet every 10 milliseconds without reloading it over SPI, only
+   pulsing the CE pin.  Once a second a new value is swapped in with 'setData'.  Basic_RX can receive the beacons.
+
+Radio -> Arduino
+
+CE    -> 9 (Must be a separate pin from CSN)
+CSN   -> 10 (Hardware SPI SS)
+MOSI  -> 11 (Hardware SPI MOSI)
+MISO  -> 12 (Hardware SPI MISO)
+SCK   -> 13 (Hardware SPI SCK)
+IRQ   -> No connection in this example
+
+VCC   -> No more than 3.6 volts
+GND   -> GND
+
+*/
+
+#include <SPI.h>
+#include <NRFLite.h>
+#include <NRFLiteBeacon.h>
+
+NRFLite _radio;
+NRFLiteBeacon _beacon(_radio);
+uint8_t _data;
+uint32_t _lastChangeMillis, _beaconCount;
+
+void setup()
+{
+	Serial.begin(115200);
+	_radio.init(1, 9, 10); // radio id, CE pin, CSN pin
+
+	if (!_beacon.begin(0, &_data, sizeof(_data))) { // beacon _data to radio id 0
+		Serial.println("CE and CSN must be separate pins");
+	}
+}
+
+void loop()
+{
+	if (_beacon.update(10000)) { _beaconCount++; } // Sends every 10,000 microseconds.
+
+	if (millis() - _lastChangeMillis > 999) {
+		_lastChangeMillis = millis();
+		_data++;
+		_beacon.setData(&_data, sizeof(_data));
+		Serial.print("Beacon "); Serial.print(_data);
+		Serial.print(", beacons sent "); Serial.println(_beaconCount);
+	}
+}
@@ -0,0 +1,67 @@
+/* Demonstrates following the channel changes made by Channel_TX.  Packets are read with NRFLiteChannelChanger
+   rather than NRFLite so the radio moves when asked to.
+
+Radio -> Arduino
+
+CE    -> 9
+CSN   -> 10 (Hardware SPI SS)
+MOSI  -> 11 (Hardware SPI MOSI)
+MISO  -> 12 (Hardware SPI MISO)
+SCK   -> 13 (Hardware SPI SCK)
+IRQ   -> No connection in this example
+
+VCC   -> No more than 3.6 volts
+GND   -> GND
+
+*/
+
+#include <SPI.h>
+#include <NRFLite.h>
+#include <NRFLiteChannelChanger.h>
+
+const static uint8_t RADIO_ID       = 0;
+const static uint8_t PIN_RADIO_CE   = 9;
+const static uint8_t PIN_RADIO_CSN  = 10;
+
+struct RadioPacket
+{
+	uint8_t FromRadioId;
+	uint32_t OnTimeMillis;
+	uint32_t FailedTxCount;
+};
+
+NRFLite _radio;
+NRFLiteChannelChanger _channelChanger(_radio);
+RadioPacket _radioData;
+uint8_t _lastChannel;
+
+void setup()
+{
+	Serial.begin(115200);
+	
+	if (!_radio.init(RADIO_ID, PIN_RADIO_CE, PIN_RADIO_CSN)) {
+		Serial.println("Cannot communicate with radio");
+		while (1) {} // Wait here forever.
+	}
+	
+	_lastChannel = _channelChanger.getChannel();
+}
+
+void loop()
+{
+	while (_channelChanger.hasData()) {
+		
+		_channelChanger.readData(&_radioData);
+		
+		Serial.print("Radio ");      Serial.print(_radioData.FromRadioId);
+		Serial.print(", ");          Serial.print(_radioData.OnTimeMillis);
+		Serial.print(" ms, ");       Serial.print(_radioData.FailedTxCount);
+		Serial.println(" Failed TX");
+	}
+	
+	if (_channelChanger.getChannel() != _lastChannel) {
+		_lastChannel = _channelChanger.getChannel();
+		Serial.print("Moved to channel ");
+		Serial.println(_lastChannel);
+	}
+}
@@ -0,0 +1,94 @@
+/* Demonstrates finding the channel with the least Wi-Fi and other 2.4 GHz traffic and moving a link to it.
+   Every minute the channels are scanned, the activity found is printed, and both radios move to the quietest channel.
+   Use with Channel_RX.  Scanning needs separate CE and CSN pins.
+
+Radio -> Arduino
+
+CE    -> 9
+CSN   -> 10 (Hardware SPI SS)
+MOSI  -> 11 (Hardware SPI MOSI)
+MISO  -> 12 (Hardware SPI MISO)
+SCK   -> 13 (Hardware SPI SCK)
+IRQ   -> No connection in this example
+
+VCC   -> No more than 3.6 volts
+GND   -> GND
+
+*/
+
+#include <SPI.h>
+#include <NRFLite.h>
+#include <NRFLiteChannelChanger.h>
+
+const static uint8_t RADIO_ID             = 1;
+const static uint8_t DESTINATION_RADIO_ID = 0;
+const static uint8_t PIN_RADIO_CE         = 9;
+const static uint8_t PIN_RADIO_CSN        = 10;
+const static uint8_t SAMPLES_PER_CHANNEL  = 8;
+
+struct RadioPacket // Any packet up to 32 bytes can be sent.
+{
+	uint8_t FromRadioId;
+	uint32_t OnTimeMillis;
+	uint32_t FailedTxCount;
+};
+
+NRFLite _radio;
+NRFLiteChannelChanger _channelChanger(_radio);
+RadioPacket _radioData;
+uint8_t _activity[126];
+uint32_t _lastScanMillis;
+
+void setup()
+{
+	Serial.begin(115200);
+	
+	if (!_radio.init(RADIO_ID, PIN_RADIO_CE, PIN_RADIO_CSN)) {
+		Serial.println("Cannot communicate with radio");
+		while (1) {} // Wait here forever.
+	}
+	
+	_radioData.FromRadioId = RADIO_ID;
+	moveToQuietestChannel();
+}
+
+void loop()
+{
+	_radioData.OnTimeMillis = millis();
+	
+	if (!_radio.send(DESTINATION_RADIO_ID, &_radioData, sizeof(_radioData))) {
+		_radioData.FailedTxCount++;
+	}
+	
+	if (millis() - _lastScanMillis > 59999) {
+		moveToQuietestChannel();
+	}
+	
+	delay(100);
+}
+
+void moveToQuietestChannel()
+{
+	_lastScanMillis = millis();
+	
+	// Print the activity on each channel as a bar, 1 character for each sample that found a signal.
+	_radio.scanChannels(_activity, SAMPLES_PER_CHANNEL);
+	
+	for (uint8_t channel = 0; channel <= 125; channel++) {
+		if (_activity[channel] == 0) continue;
+		Serial.print("Channel "); Serial.print(channel); Serial.print(" ");
+		for (uint8_t i = 0; i < _activity[channel]; i++) Serial.print('#');
+		Serial.println();
+	}
+	
+	uint8_t channel = _radio.getQuietestChannel(SAMPLES_PER_CHANNEL);
+	
+	if (_channelChanger.moveToChannel(DESTINATION_RADIO_ID, channel)) {
+		Serial.print("Using channel ");
+	}
+	else {
+		Serial.print("Could not move the receiver, still using channel ");
+	}
+	
+	Serial.println(_channelChanger.getChannel());
+}
@@ -0,0 +1,50 @@
+/* Demonstrates receiving with NRFLiteRxBuffer.  The interrupt handler quickly moves packets from the radio into RAM
+   so bursts of packets are not lost while the loop is busy, like when it is printing to the serial port.
+
+Radio -> Arduino
+
+CE    -> 9
+CSN   -> 10 (Hardware SPI SS)
+MOSI  -> 11 (Hardware SPI MOSI)
+MISO  -> 12 (Hardware SPI MISO)
+SCK   -> 13 (Hardware SPI SCK)
+IRQ   -> 3  (Hardware INT1)
+
+VCC   -> No more than 3.6 volts
+GND   -> GND
+
+*/
+
+#include <SPI.h>
+#include <NRFLite.h>
+#include <NRFLiteRxBuffer.h>
+
+NRFLite _radio;
+NRFLiteRxBuffer<8> _rxBuffer(_radio); // Holds up to 8 packets.
+
+void setup()
+{
+	Serial.begin(115200);
+	_radio.init(0, 9, 10); // radio id, CE pin, CSN pin
+	attachInterrupt(1, radioInterrupt, FALLING); // INT1 = digital pin 3
+}
+
+void loop()
+{
+	NRFLiteRxBuffer<8>::Packet* packet = _rxBuffer.peek();
+	
+	while (packet) {
+		Serial.print("Received "); Serial.print(packet->Length); Serial.print(" bytes, first byte ");
+		Serial.println(packet->Data[0]);
+		_rxBuffer.pop();
+		packet = _rxBuffer.peek();
+	}
+	
+	Serial.print("Dropped packets "); Serial.println(_rxBuffer.getOverrunCount());
+	delay(1000);
+}
+
+void radioInterrupt()
+{
+	_rxBuffer.handleInterrupt();
+}
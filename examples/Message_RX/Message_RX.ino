@@ -0,0 +1,57 @@
+/* Demonstrates receiving messages larger than 32 bytes with NRFLiteMessageReceiver.  Use with Message_TX.
+
+Radio -> Arduino
+
+CE    -> 9
+CSN   -> 10 (Hardware SPI SS)
+MOSI  -> 11 (Hardware SPI MOSI)
+MISO  -> 12 (Hardware SPI MISO)
+SCK   -> 13 (Hardware SPI SCK)
+IRQ   -> No connection in this example
+
+VCC   -> No more than 3.6 volts
+GND   -> GND
+
+*/
+
+#include <SPI.h>
+#include <NRFLite.h>
+#include <NRFLiteMessage.h>
+
+const static uint8_t RADIO_ID       = 0;
+const static uint8_t PIN_RADIO_CE   = 9;
+const static uint8_t PIN_RADIO_CSN  = 10;
+const static uint16_t MAX_LENGTH    = 1000;
+
+NRFLite _radio;
+NRFLiteMessageReceiver _receiver(_radio);
+uint8_t _message[MAX_LENGTH];
+
+void setup()
+{
+	Serial.begin(115200);
+	
+	if (!_radio.init(RADIO_ID, PIN_RADIO_CE, PIN_RADIO_CSN, NRFLite::BITRATE2MBPS)) {
+		Serial.println("Cannot communicate with radio");
+		while (1) {} // Wait here forever.
+	}
+	
+	_receiver.begin(_message, MAX_LENGTH);
+}
+
+void loop()
+{
+	uint16_t length = _receiver.receiveMessage();
+	
+	if (length > 0) {
+		
+		// Message_TX fills its message with this pattern.
+		uint8_t isValid = 1;
+		for (uint16_t i = 0; i < length; i++) {
+			if (_message[i] != (uint8_t)(i * 7)) { isValid = 0; }
+		}
+		
+		Serial.print("Received "); Serial.print(length); Serial.print(" bytes");
+		Serial.println(isValid ? "" : " with incorrect data");
+	}
+}
@@ -0,0 +1,103 @@
+/* Demonstrates sending messages larger than 32 bytes with NRFLiteMessageSender.  Use with Message_RX.
+   Each message is also sent the way it would be without NRFLiteMessageSender, one fragment at a time with 'send'
+   and repeating any that fail, so the bitrates of the two approaches can be compared.
+
+Radio -> Arduino
+
+CE    -> 9
+CSN   -> 10 (Hardware SPI SS)
+MOSI  -> 11 (Hardware SPI MOSI)
+MISO  -> 12 (Hardware SPI MISO)
+SCK   -> 13 (Hardware SPI SCK)
+IRQ   -> No connection in this example
+
+VCC   -> No more than 3.6 volts
+GND   -> GND
+
+*/
+
+#include <SPI.h>
+#include <NRFLite.h>
+#include <NRFLiteMessage.h>
+
+const static uint8_t RADIO_ID             = 1;
+const static uint8_t DESTINATION_RADIO_ID = 0;
+const static uint8_t PIN_RADIO_CE         = 9;
+const static uint8_t PIN_RADIO_CSN        = 10;
+const static uint16_t MESSAGE_LENGTH      = 1000;
+
+NRFLite _radio;
+NRFLiteMessageSender _sender(_radio);
+uint8_t _message[MESSAGE_LENGTH];
+uint8_t _messageCount;
+
+void setup()
+{
+	Serial.begin(115200);
+	
+	if (!_radio.init(RADIO_ID, PIN_RADIO_CE, PIN_RADIO_CSN, NRFLite::BITRATE2MBPS)) {
+		Serial.println("Cannot communicate with radio");
+		while (1) {} // Wait here forever.
+	}
+	
+	// Message_RX checks the message contains this pattern.
+	for (uint16_t i = 0; i < MESSAGE_LENGTH; i++) {
+		_message[i] = i * 7;
+	}
+}
+
+void loop()
+{
+	_messageCount++;
+	
+	if (_sender.sendMessage(DESTINATION_RADIO_ID, _message, MESSAGE_LENGTH)) {
+		Serial.print("sendMessage "); Serial.print(_sender.getGoodput()); Serial.println(" bps");
+	}
+	else {
+		Serial.println("sendMessage failed");
+	}
+	
+	delay(1000);
+	
+	uint32_t startMillis = millis();
+	
+	if (sendOneFragmentAtATime()) {
+		uint32_t elapsedMillis = millis() - startMillis;
+		uint32_t bitsPerSecond = MESSAGE_LENGTH * 8 / (float)elapsedMillis * 1000;
+		Serial.print("send        "); Serial.print(bitsPerSecond); Serial.println(" bps");
+	}
+	else {
+		Serial.println("send failed");
+	}
+	
+	delay(1000);
+}
+
+uint8_t sendOneFragmentAtATime()
+{
+	// Uses the same fragment header as NRFLiteMessageSender so Message_RX can assemble the message: the message id
+	// followed by the fragment number, which has its top bit set on the last fragment.  The message id differs from the
+	// ones used by '_sender' before and after this message.
+	uint8_t messageId = _messageCount + 128;
+	uint16_t fragmentCount = (MESSAGE_LENGTH + 28) / 29;
+	
+	for (uint16_t fragment = 0; fragment < fragmentCount; fragment++) {
+		
+		uint16_t dataOffset = fragment * 29;
+		uint8_t dataLength = MESSAGE_LENGTH - dataOffset < 29 ? MESSAGE_LENGTH - dataOffset : 29;
+		uint16_t fragmentNumber = fragment == fragmentCount - 1 ? fragment | 0x8000 : fragment;
+		
+		uint8_t packet[32];
+		packet[0] = messageId;
+		packet[1] = fragmentNumber;
+		packet[2] = fragmentNumber >> 8;
+		memcpy(packet + 3, _message + dataOffset, dataLength);
+		
+		uint8_t failureCount = 0;
+		while (!_radio.send(DESTINATION_RADIO_ID, packet, dataLength + 3)) {
+			if (++failureCount == 16) { return 0; }
+		}
+	}
+	
+	return 1;
+}
@@ -0,0 +1,77 @@
+/* Demonstrates 2 radios on the same SPI bus, each receiving on its own channel so together they can receive twice as
+   many packets as one radio.  Transmitters like Basic_TX send to radio id 0, with 'init' given channel 90 or 110.
+   The first radio is checked from the loop while the second is handled by an interrupt.  'spiUsingInterrupt' holds
+   that interrupt off while the loop is talking to either radio, so the interrupt cannot corrupt a transfer in progress.
+
+Radio 1 -> Arduino
+
+CE    -> 9
+CSN   -> 10 (Hardware SPI SS)
+MOSI  -> 11 (Hardware SPI MOSI)
+MISO  -> 12 (Hardware SPI MISO)
+SCK   -> 13 (Hardware SPI SCK)
+IRQ   -> No connection in this example
+
+Radio 2 -> Arduino
+
+CE    -> 7
+CSN   -> 8
+MOSI  -> 11 (Hardware SPI MOSI)
+MISO  -> 12 (Hardware SPI MISO)
+SCK   -> 13 (Hardware SPI SCK)
+IRQ   -> 3  (Hardware INT1)
+
+VCC   -> No more than 3.6 volts
+GND   -> GND
+
+*/
+
+#include <SPI.h>
+#include <NRFLite.h>
+
+NRFLite _radio1, _radio2;
+volatile uint32_t _radio2Packets;
+uint32_t _radio1Packets, _lastPrintMillis;
+
+void setup()
+{
+	Serial.begin(115200);
+	_radio1.init(0, 9, 10, NRFLite::BITRATE2MBPS, 90);  // radio id, CE pin, CSN pin, bitrate, channel
+	_radio2.init(0, 7, 8, NRFLite::BITRATE2MBPS, 110);
+
+	_radio2.spiUsingInterrupt(digitalPinToInterrupt(3));
+	attachInterrupt(digitalPinToInterrupt(3), radio2Interrupt, FALLING);
+}
+
+void loop()
+{
+	uint8_t data[32];
+
+	while (_radio1.hasData()) {
+		_radio1.readData(data);
+		_radio1Packets++;
+	}
+
+	if (millis() - _lastPrintMillis > 999) {
+		_lastPrintMillis = millis();
+
+		noInterrupts();
+		uint32_t radio2Packets = _radio2Packets;
+		interrupts();
+
+		Serial.print("Radio 1 packets "); Serial.print(_radio1Packets);
+		Serial.print(", radio 2 packets "); Serial.println(radio2Packets);
+	}
+}
+
+void radio2Interrupt()
+{
+	uint8_t tx_ok, tx_fail, rx_ready;
+	_radio2.whatHappened(tx_ok, tx_fail, rx_ready);
+
+	uint8_t data[32];
+	while (_radio2.hasDataISR()) { // Use hasDataISR rather than hasData inside an interrupt service routine.
+		_radio2.readData(data);
+		_radio2Packets++;
+	}
+}
@@ -0,0 +1,64 @@
+/* Demonstrates NRFLiteRouter, which relays packets through other radios to reach radios that are out of range.
+   Load this sketch onto 3 Arduinos, changing RADIO_ID to 0, 1, and 2.  Radio 1 sends to radio 0 through radio 2,
+   which sends the packets on.  Radio 0 prints each packet with the number of hops it took.
+
+Radio -> Arduino
+
+CE    -> 9
+CSN   -> 10 (Hardware SPI SS)
+MOSI  -> 11 (Hardware SPI MOSI)
+MISO  -> 12 (Hardware SPI MISO)
+SCK   -> 13 (Hardware SPI SCK)
+IRQ   -> No connection in this example
+
+VCC   -> No more than 3.6 volts
+GND   -> GND
+
+*/
+
+#include <SPI.h>
+#include <NRFLite.h>
+#include <NRFLiteRouter.h>
+
+const static uint8_t RADIO_ID = 1;             // Our radio's id: 0 receives, 1 sends, and 2 relays.
+const static uint8_t DESTINATION_RADIO_ID = 0;
+const static uint8_t RELAY_RADIO_ID = 2;
+
+struct RadioPacket // Any packet up to 27 bytes can be sent.
+{
+	uint32_t OnTimeMillis;
+	uint32_t FailedTxCount;
+};
+
+NRFLite _radio;
+NRFLiteRouter<4, 4> _router(_radio, RADIO_ID); // Up to 4 routes and 4 packets waiting to be sent.
+RadioPacket _radioData;
+uint32_t _lastSendMillis;
+
+void setup()
+{
+	Serial.begin(115200);
+	_radio.init(RADIO_ID, 9, 10); // radio id, CE pin, CSN pin
+
+	if (RADIO_ID == 1) {
+		_router.addRoute(DESTINATION_RADIO_ID, RELAY_RADIO_ID); // Reach radio 0 through radio 2.
+	}
+}
+
+void loop()
+{
+	while (_router.hasData()) { // Also sends on packets for other radios, so it is called on every pass.
+		_router.readData(&_radioData);
+		Serial.print("Radio "); Serial.print(_router.getFromRadioId());
+		Serial.print(", "); Serial.print(_router.getHopCount()); Serial.print(" hops");
+		Serial.print(", time "); Serial.print(_radioData.OnTimeMillis);
+		Serial.print(", failed "); Serial.println(_radioData.FailedTxCount);
+	}
+
+	if (RADIO_ID == 1 && millis() - _lastSendMillis > 999) {
+		_lastSendMillis = millis();
+		_radioData.OnTimeMillis = millis();
+		_radioData.FailedTxCount = _router.getDroppedCount();
+		_router.send(DESTINATION_RADIO_ID, &_radioData, sizeof(_radioData));
+	}
+}
@@ -0,0 +1,77 @@
+/* Demonstrates the counters each radio keeps, which show where time goes without a logic analyzer.
+   Use with a receiver like Basic_RX.
+
+Radio -> Arduino
+
+CE    -> 9
+CSN   -> 10 (Hardware SPI SS)
+MOSI  -> 11 (Hardware SPI MOSI)
+MISO  -> 12 (Hardware SPI MISO)
+SCK   -> 13 (Hardware SPI SCK)
+IRQ   -> No connection in this example
+
+VCC   -> No more than 3.6 volts
+GND   -> GND
+
+*/
+
+#include <SPI.h>
+#include <NRFLite.h>
+
+const static uint8_t RADIO_ID             = 1;
+const static uint8_t DESTINATION_RADIO_ID = 0;
+const static uint8_t PIN_RADIO_CE         = 9;
+const static uint8_t PIN_RADIO_CSN        = 10;
+
+struct RadioPacket // Any packet up to 32 bytes can be sent.
+{
+	uint8_t FromRadioId;
+	uint32_t OnTimeMillis;
+	uint32_t FailedTxCount;
+};
+
+NRFLite _radio;
+RadioPacket _radioData;
+uint32_t _lastMillis;
+
+void setup()
+{
+	Serial.begin(115200);
+	
+	if (!_radio.init(RADIO_ID, PIN_RADIO_CE, PIN_RADIO_CSN)) {
+		Serial.println("Cannot communicate with radio");
+		while (1) {} // Wait here forever.
+	}
+	
+	_radioData.FromRadioId = RADIO_ID;
+	_lastMillis = millis();
+}
+
+void loop()
+{
+	_radioData.OnTimeMillis = millis();
+	
+	if (!_radio.send(DESTINATION_RADIO_ID, &_radioData, sizeof(_radioData))) {
+		_radioData.FailedTxCount++;
+	}
+	
+	if (millis() - _lastMillis > 4999) {
+		
+		// Print the counters for the last 5 seconds.
+		NRFLite::Stats stats = _radio.getStats();
+		_radio.resetStats();
+		_lastMillis = millis();
+		
+		Serial.print("Sent ");        Serial.print(stats.PacketsSent);
+		Serial.print(", acked ");     Serial.print(stats.PacketsAcked);
+		Serial.print(", failed ");    Serial.print(stats.PacketsFailed);
+		Serial.print(", retries ");   Serial.println(stats.Retries);
+		Serial.print("SPI transactions "); Serial.print(stats.SpiTransactions);
+		Serial.print(", bytes ");     Serial.print(stats.SpiBytes);
+		Serial.print(", saved ");     Serial.println(stats.SpiBytesSaved);
+		Serial.print("RX flushes ");  Serial.print(stats.RxFifoFlushes);
+		Serial.print(", TX flushes "); Serial.print(stats.TxFifoFlushes);
+		Serial.print(", waiting ");   Serial.print(stats.WaitMicros / 1000); Serial.println(" ms");
+		Serial.println();
+	}
+}
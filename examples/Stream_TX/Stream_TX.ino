@@ -0,0 +1,69 @@
+/* Demonstrates streaming packets with NRFLiteStreamer, which keeps the radio's TX FIFO buffer full so the
+   radio does not wait for the next packet to be loaded.  Use with a receiver that reports its bitrate, like RX_ATtiny85.
+
+Radio -> Arduino
+
+CE    -> 9
+CSN   -> 10 (Hardware SPI SS)
+MOSI  -> 11 (Hardware SPI MOSI)
+MISO  -> 12 (Hardware SPI MISO)
+SCK   -> 13 (Hardware SPI SCK)
+IRQ   -> No connection in this example
+
+VCC   -> No more than 3.6 volts
+GND   -> GND
+
+*/
+
+#include <SPI.h>
+#include <NRFLite.h>
+#include <NRFLiteStreamer.h>
+
+const static uint8_t RADIO_ID             = 1;
+const static uint8_t DESTINATION_RADIO_ID = 0;
+const static uint8_t PIN_RADIO_CE         = 9;
+const static uint8_t PIN_RADIO_CSN        = 10;
+
+struct RadioPacket { uint8_t Counter; uint8_t Data[31]; };
+
+NRFLite _radio;
+NRFLiteStreamer _streamer(_radio);
+RadioPacket _radioData;
+uint32_t _successPacketCount, _failedPacketCount;
+uint64_t _lastMillis;
+
+void setup()
+{
+	Serial.begin(115200);
+	
+	if (!_radio.init(RADIO_ID, PIN_RADIO_CE, PIN_RADIO_CSN, NRFLite::BITRATE2MBPS)) {
+		Serial.println("Cannot communicate with radio");
+		while (1) {} // Wait here forever.
+	}
+	
+	_streamer.begin(DESTINATION_RADIO_ID); // Use NRFLite::NO_ACK as the 2nd parameter to stream without acknowledgments.
+	_lastMillis = millis();
+}
+
+void loop()
+{
+	_radioData.Counter++;
+	_streamer.write(&_radioData, sizeof(_radioData));
+	
+	while (_streamer.hasResult()) {
+		if (_streamer.readResult()) { _successPacketCount++; }
+		else                        { _failedPacketCount++;  }
+	}
+	
+	uint64_t currentMillis = millis();
+	
+	if (currentMillis - _lastMillis > 999) {
+		uint32_t bitsPerSecond = sizeof(RadioPacket) * _successPacketCount * 8 / (float)(currentMillis - _lastMillis) * 1000;
+		Serial.print(_successPacketCount); Serial.print("/");
+		Serial.print(_successPacketCount + _failedPacketCount); Serial.print(" packets ");
+		Serial.print(bitsPerSecond); Serial.println(" bps");
+		_successPacketCount = 0;
+		_failedPacketCount = 0;
+		_lastMillis = currentMillis;
+	}
+}
@@ -0,0 +1,82 @@
+/* Demonstrates NRFLiteTxQueue, which holds packets for many radios and sends all those waiting for a radio in one batch.
+   Every 100 milliseconds a command is queued for each of radio ids 2 - 9, with the one for radio id 2 given a higher
+   priority so it goes out first.  Commands not sent within 50 milliseconds are dropped.  The queue is given 5
+   milliseconds per loop, after which the radio listens again for replies from the radios.
+
+Radio -> Arduino
+
+CE    -> 9
+CSN   -> 10 (Hardware SPI SS)
+MOSI  -> 11 (Hardware SPI MOSI)
+MISO  -> 12 (Hardware SPI MISO)
+SCK   -> 13 (Hardware SPI SCK)
+IRQ   -> No connection in this example
+
+VCC   -> No more than 3.6 volts
+GND   -> GND
+
+*/
+
+#include <SPI.h>
+#include <NRFLite.h>
+#include <NRFLiteTxQueue.h>
+
+const static uint8_t RADIO_ID           = 1;
+const static uint8_t FIRST_NODE_ID      = 2;
+const static uint8_t NODE_COUNT         = 8;
+const static uint8_t PIN_RADIO_CE       = 9;
+const static uint8_t PIN_RADIO_CSN      = 10;
+
+struct CommandPacket { uint8_t Command; uint8_t Value; };
+
+void commandSent(uint8_t toRadioId, uint8_t success);
+
+NRFLite _radio;
+NRFLiteTxQueue<16> _queue(_radio, commandSent);
+uint32_t _lastCommandMillis, _failedCommandCount;
+uint8_t _value;
+
+void setup()
+{
+	Serial.begin(115200);
+	
+	if (!_radio.init(RADIO_ID, PIN_RADIO_CE, PIN_RADIO_CSN)) {
+		Serial.println("Cannot communicate with radio");
+		while (1) {} // Wait here forever.
+	}
+}
+
+void loop()
+{
+	if (millis() - _lastCommandMillis > 99) {
+		_lastCommandMillis = millis();
+		_value++;
+		
+		for (uint8_t i = 0; i < NODE_COUNT; i++) {
+			uint8_t nodeId = FIRST_NODE_ID + i;
+			CommandPacket command = { 1, _value };
+			uint8_t priority = nodeId == FIRST_NODE_ID ? 1 : 0;
+			if (!_queue.add(nodeId, &command, sizeof(command), priority, 50)) { // priority, deadline in milliseconds
+				Serial.println("Queue is full");
+			}
+		}
+	}
+	
+	_queue.update(5000); // Send for up to 5,000 microseconds, then listen.
+	
+	uint8_t length;
+	while ((length = _radio.hasData())) {
+		uint8_t data[32];
+		_radio.readData(data);
+		Serial.print("Received "); Serial.print(length); Serial.println(" bytes");
+	}
+}
+
+void commandSent(uint8_t toRadioId, uint8_t success)
+{
+	if (!success) {
+		_failedCommandCount++;
+		Serial.print("Command to radio "); Serial.print(toRadioId);
+		Serial.print(" failed, "); Serial.print(_failedCommandCount); Serial.println(" failures");
+	}
+}
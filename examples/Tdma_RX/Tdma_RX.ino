@@ -0,0 +1,59 @@
+/* Demonstrates NRFLiteTdmaReceiver, which gives each node sending to this radio its own time slot so their packets
+   never collide.  Up to 8 nodes running Tdma_TX, each with its own radio id, join the frame by themselves.  Once a
+   second the number of nodes with a slot and the packets received from them are printed.
+
+Radio -> Arduino
+
+CE    -> 9
+CSN   -> 10 (Hardware SPI SS)
+MOSI  -> 11 (Hardware SPI MOSI)
+MISO  -> 12 (Hardware SPI MISO)
+SCK   -> 13 (Hardware SPI SCK)
+IRQ   -> No connection in this example
+
+VCC   -> No more than 3.6 volts
+GND   -> GND
+
+*/
+
+#include <SPI.h>
+#include <NRFLite.h>
+#include <NRFLiteTdma.h>
+
+const static uint8_t RADIO_ID = 0;
+const static uint8_t SLOT_COUNT = 8;
+
+struct RadioPacket // Any packet up to 32 bytes can be sent.
+{
+	uint8_t FromRadioId;
+	uint32_t OnTimeMillis;
+};
+
+NRFLite _radio;
+NRFLiteTdmaReceiver _receiver(_radio);
+RadioPacket _radioData;
+uint32_t _packetCount, _lastPrintMillis;
+
+void setup()
+{
+	Serial.begin(115200);
+	_radio.init(RADIO_ID, 9, 10, NRFLite::BITRATE2MBPS); // radio id, CE pin, CSN pin, bitrate
+	_receiver.begin(SLOT_COUNT, sizeof(RadioPacket));      // Slots only need to fit the packets being sent.
+
+	Serial.print("Frame of "); Serial.print(_receiver.getFrameMicros()); Serial.println(" microseconds");
+}
+
+void loop()
+{
+	while (_receiver.hasData()) { // Also sends the beacons, so it is called on every pass.
+		_receiver.readData(&_radioData);
+		_packetCount++;
+	}
+
+	if (millis() - _lastPrintMillis > 999) {
+		_lastPrintMillis = millis();
+		Serial.print("Nodes "); Serial.print(_receiver.getNodeCount());
+		Serial.print(", packets "); Serial.print(_packetCount);
+		Serial.print(", last from radio "); Serial.println(_radioData.FromRadioId);
+	}
+}
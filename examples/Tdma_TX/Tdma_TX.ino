@@ -0,0 +1,63 @@
+/* Demonstrates NRFLiteTdmaSender, which sends to Tdma_RX only in the time slot it is given, so many nodes can send to
+   the same receiver without colliding.  Give each node its own RADIO_ID.  The node joins the frame once it hears a
+   beacon from the receiver, then sends a packet every 100 milliseconds.
+
+Radio -> Arduino
+
+CE    -> 9 (Must be a separate pin from CSN)
+CSN   -> 10 (Hardware SPI SS)
+MOSI  -> 11 (Hardware SPI MOSI)
+MISO  -> 12 (Hardware SPI MISO)
+SCK   -> 13 (Hardware SPI SCK)
+IRQ   -> No connection in this example
+
+VCC   -> No more than 3.6 volts
+GND   -> GND
+
+*/
+
+#include <SPI.h>
+#include <NRFLite.h>
+#include <NRFLiteTdma.h>
+
+const static uint8_t RADIO_ID = 1;             // Our radio's id.  Each node needs its own.
+const static uint8_t DESTINATION_RADIO_ID = 0; // Id of the radio running Tdma_RX.
+
+struct RadioPacket // Any packet up to 32 bytes can be sent.
+{
+	uint8_t FromRadioId;
+	uint32_t OnTimeMillis;
+};
+
+NRFLite _radio;
+NRFLiteTdmaSender _sender(_radio);
+RadioPacket _radioData;
+uint32_t _lastSendMillis;
+
+void setup()
+{
+	Serial.begin(115200);
+	_radio.init(RADIO_ID, 9, 10, NRFLite::BITRATE2MBPS); // radio id, CE pin, CSN pin, bitrate
+
+	if (!_sender.begin(DESTINATION_RADIO_ID)) {
+		Serial.println("CE and CSN must be separate pins");
+	}
+
+	_radioData.FromRadioId = RADIO_ID;
+}
+
+void loop()
+{
+	_sender.update(); // Listens for the beacons and sends in the slot, so it is called on every pass.
+
+	if (millis() - _lastSendMillis > 99 && _sender.hasSlot() && !_sender.isBusy()) {
+		_lastSendMillis = millis();
+
+		if (_sender.getResult() == NRFLiteTdmaSender::SEND_FAILED) {
+			Serial.println("Last packet failed");
+		}
+
+		_radioData.OnTimeMillis = millis();
+		_sender.send(&_radioData, sizeof(_radioData));
+	}
+}
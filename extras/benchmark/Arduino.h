@@ -0,0 +1,55 @@
+// The parts of the Arduino core used by the library, for building it on a PC against the emulator.
+// Time is simulated by the emulator, see nRF24L01Emulator.h.
+
+#ifndef _Arduino_h_
+#define _Arduino_h_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include "binary.h"
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT  0x0
+#define OUTPUT 0x1
+
+#define DEC 10
+#define HEX 16
+
+#define _BV(bit) (1 << (bit))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+
+unsigned long micros();
+unsigned long millis();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// There are no interrupt handlers on the PC.
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+// Writes to standard output.
+class Stream {
+
+    public:
+
+    void print(const char* s)                     { printf("%s", s); }
+    void print(char c)                            { printf("%c", c); }
+    void print(double value)                      { printf("%.2f", value); }
+    void print(int value, int base = DEC)         { print((long)value, base); }
+    void print(unsigned int value, int base = DEC){ print((unsigned long)value, base); }
+    void print(uint8_t value, int base = DEC)     { print((unsigned long)value, base); }
+    void print(long value, int base = DEC)        { printf(base == HEX ? "%lX" : "%ld", value); }
+    void print(unsigned long value, int base = DEC) { printf(base == HEX ? "%lX" : "%lu", value); }
+
+    template<typename T> void println(T value)           { print(value); printf("\n"); }
+    template<typename T> void println(T value, int base) { print(value, base); printf("\n"); }
+    void println()                                       { printf("\n"); }
+};
+
+extern Stream Serial;
+
+#endif
@@ -0,0 +1,1288 @@
+// Measures NRFLite throughput and latency against the nRF24L01+ emulator, using the scenarios of the TX_Tests and
+// RX_Tests examples for each bitrate with shared and separate CE and CSN pins.  Results are printed as CSV, or as JSON
+// with --json, and compare_baseline.py compares them with the results in baseline.csv.
+//
+// Build and run from this folder:
+//
+//     g++ -O2 -DNRFLITE_EXTERNAL_TRANSPORT -I. -I../.. -o benchmark Benchmark.cpp nRF24L01Emulator.cpp ../../NRFLite*.cpp
+//     ./benchmark > results.csv
+//     python3 compare_baseline.py baseline.csv results.csv
+//
+// The numbers come from the timing model of the emulator, not from hardware, so they show how changes to the library
+// affect it rather than what a particular board will achieve.  Runs are repeatable:  the same library code always
+// produces the same results.
+//
+// Columns:
+//   packets                  = Calls to 'send' or 'startSend', requests for the request and response scenario, or
+//                              beacons sent.
+//   success_pct              = Packets received by the receiving radio, or replies received, as a percent of 'packets'.
+//   bps                      = Payload bits received by the receiving radio, or in replies, per second.
+//   tx_spi_bytes_per_packet  = SPI bytes between the transmitting microcontroller and its radio, per packet.
+//   rx_spi_bytes_per_packet  = SPI bytes between the receiving microcontroller and its radio, per packet received.
+//   send_p50_us, send_p99_us = Time spent in 'send', or in 'startSend' for the interrupt scenarios.  For the request and
+//                              response scenario it is the round trip, from sending a packet until the reply is read.
+//   tx_on_us_per_packet      = Time the transmitting radio was powered up, per packet, which is also the milliseconds
+//                              per 1000 packets.  Only the sensor scenarios power their radio down, so it is 0 for the
+//                              others.
+//
+// The request and response scenario has both radios on the same microcontroller, so the turnaround of each radio
+// between sending and listening is timed.  The reply is the received packet sent straight back.  The 8 byte scenarios
+// compare the address widths and CRC lengths given to 'init' for small packets.  The beacon scenario, compared with
+// polling_no_ack, shows the SPI traffic and rate of sending a packet loaded once with NRFLiteBeacon.  The gateway
+// scenarios have 1 to 3 radios on the SPI bus of one microcontroller, each receiving from its own sensor on its own
+// channel, to show how throughput grows with the number of radios.  Their send times are from the sensor submitting
+// a packet to NRFLiteAsyncSender until it sees the packet complete.  The destinations scenarios have a gateway sending
+// rounds of packets to 4 radios in turn, with 'send' and a 'hasData' check after each packet, or through NRFLiteTxQueue.
+// Their send times are per round.  The uplink scenarios have 4 to 22 nodes, each on its own microcontroller, sending to
+// one receiver on the same channel as fast as they can, either with NRFLiteAsyncSender and its automatic retries,
+// colliding with each other, or in the time slots of NRFLiteTdmaSender.  NRFLiteAsyncSender nodes pause for a random
+// time of up to 4 packet exchanges per node before each packet, and each retries after a random delay of its own.
+// A packet sent again after its ACK packet was lost reaches the receiver twice, so only the first copy is counted, and
+// success_pct also counts the packets that arrived while their node was still waiting to learn so.
+// The nodes use separate CE and CSN pins, as NRFLiteTdmaSender requires, and the pin setting is for the receiver.
+// Their send times are from a node queuing a packet until it completes, and the TDMA nodes join the frame before the
+// measurement starts.  The routing scenarios relay packets with NRFLiteRouter from a source through 0 to 3 relays to
+// the receiver, all in range of each other on one channel, with the send type given to every hop.  Their send times
+// are from the source queuing a packet until the receiver reads it, and success_pct is the packets delivered end to end.
+// The sensor scenarios take a 2 or 4 byte sample every 10 ms and power the radio down between sends, either sending
+// each sample on its own or batching them with NRFLiteBatchSender, which sends a batch once it is full or its oldest
+// sample is 80 ms old.  Their packets are the samples, and their send times are from a sample being taken until the
+// receiver unpacks it.  The streamer scenarios write packets with NRFLiteStreamer as fast as it takes them, to compare
+// with polling and polling_no_ack.  One writes 40 bytes, of which the 32 that fit in a packet are sent, so its bps
+// counts 32 bytes per packet.  The message scenarios send 1 KB messages to NRFLiteMessageReceiver, either with
+// NRFLiteMessageSender or one fragment at a time with 'send', repeating any that fail, as Message_TX does.  Their
+// packets are messages, and their send times are per message.  The overflow scenario gives the receiver a buffer too
+// small for the message, so every message fails.  The link adapter scenarios send with NRFLiteLinkAdapter, to compare
+// with polling, polling_10pct_loss and polling_ack_payload, with the longest ACK packet given to the adapter.  The
+// emulator does not model output power, so they show the effect of the adapter's retry settings alone.
+//
+// The benchmark also checks that 'sendMessage' rejects messages over 32 KB and only succeeds for messages the receiver
+// completed with the data sent.  Failed checks are printed to standard error and the benchmark exits with 1.
+
+#include <stdlib.h>
+#include <vector>
+#include <algorithm>
+#include <NRFLite.h>
+#include <NRFLiteBeacon.h>
+#include <NRFLiteAsyncSender.h>
+#include <NRFLiteTxQueue.h>
+#include <NRFLiteTdma.h>
+#include <NRFLiteRouter.h>
+#include <NRFLiteBatch.h>
+#include <NRFLiteStreamer.h>
+#include <NRFLiteMessage.h>
+#include <NRFLiteLinkAdapter.h>
+#include <nRF24L01Emulator.h>
+
+const static uint8_t TX_RADIO_ID = 1;
+const static uint8_t RX_RADIO_ID = 0;
+const static uint8_t PIN_TX_RADIO_CE = 9;
+const static uint8_t PIN_TX_RADIO_CSN = 10;
+const static uint8_t PIN_RX_RADIO_CE = 19;
+const static uint8_t PIN_RX_RADIO_CSN = 20;
+const static uint16_t RECEIVER_LOOP_MICROS = 20; // How often the receiving program checks its radio.
+const static uint16_t WARM_UP_MILLIS = 10;
+const static uint16_t REPLY_TIMEOUT_MICROS = 20000;
+const static uint8_t MAX_GATEWAY_RADIOS = 3;
+const static uint8_t PIN_GATEWAY_RADIO_CE[] = { 30, 31, 32 };
+const static uint8_t PIN_GATEWAY_RADIO_CSN[] = { 40, 41, 42 };
+const static uint8_t PIN_SENSOR_RADIO_CE[] = { 50, 51, 52 };
+const static uint8_t PIN_SENSOR_RADIO_CSN[] = { 60, 61, 62 };
+const static uint8_t GATEWAY_CHANNELS[] = { 80, 100, 120 };
+const static uint8_t MAX_DESTINATIONS = 4;
+const static uint8_t DESTINATION_RADIO_ID = 2; // Ids of the destination radios start here.
+const static uint8_t PIN_DESTINATION_RADIO_CE[] = { 70, 71, 72, 73 };
+const static uint8_t PIN_DESTINATION_RADIO_CSN[] = { 80, 81, 82, 83 };
+const static uint8_t ROUND_PACKETS = 12;       // Packets the gateway has for the destinations each time it sends.
+const static uint8_t MAX_NODES = 22;
+const static uint8_t PIN_NODE_RADIO_CE = 100;  // Pins of the uplink nodes are numbered from these.
+const static uint8_t PIN_NODE_RADIO_CSN = 130;
+const static uint16_t JOIN_TIMEOUT_MILLIS = 3000;
+const static uint8_t NODE_PAUSE_PACKETS = 4;   // Packet exchanges per node in the longest pause of the uplink nodes.
+const static uint8_t MAX_HOPS = 4;
+const static uint8_t HOP_RADIO_ID = 1;         // Ids of the source and relay radios start here.
+const static uint8_t PIN_HOP_RADIO_CE = 160;   // Pins of the source and relays are numbered from these.
+const static uint8_t PIN_HOP_RADIO_CSN = 170;
+const static uint16_t SOURCE_INTERVAL_MICROS = 10000;
+const static uint16_t SAMPLE_INTERVAL_MICROS = 10000;
+const static uint16_t BATCH_MAX_AGE_MILLIS = 80;
+const static uint16_t MESSAGE_LENGTH = 1024;
+const static uint16_t OVERFLOW_BUFFER_LENGTH = 1000; // Receiver buffer of the overflow scenario.
+const static uint8_t MAX_FRAGMENT_FAILURES = 16;    // Failures in a row before sending one fragment at a time gives up.
+
+// POLLING and INTERRUPTS send with 'send' and 'startSend', REQUEST_RESPONSE uses 'sendRequestAndReply', BEACON
+// sends with NRFLiteBeacon as fast as it allows, GATEWAY receives from sensors with 'runGatewayScenario', and
+// DESTINATIONS_SEND and DESTINATIONS_QUEUE send to several radios with 'runDestinationsScenario', UPLINK_ALOHA and
+// UPLINK_TDMA have many nodes sending to one receiver with 'runUplinkScenario', ROUTING relays packets along a
+// chain of radios with 'runRoutingScenario', SENSOR_SEND and SENSOR_BATCH send samples with 'runSensorScenario',
+// STREAMER writes packets with NRFLiteStreamer, MESSAGE, MESSAGE_SEND and MESSAGE_OVERFLOW send messages with
+// 'runMessageScenario', and LINK_ADAPTER sends with NRFLiteLinkAdapter.
+enum Modes { POLLING, INTERRUPTS, REQUEST_RESPONSE, BEACON, GATEWAY, DESTINATIONS_SEND, DESTINATIONS_QUEUE,
+             UPLINK_ALOHA, UPLINK_TDMA, ROUTING, SENSOR_SEND, SENSOR_BATCH, STREAMER, MESSAGE, MESSAGE_SEND,
+             MESSAGE_OVERFLOW, LINK_ADAPTER };
+
+struct Scenario {
+    const char* Name;
+    Modes Mode;
+    NRFLite::SendType SendType;
+    uint8_t PacketLength;   // 0 = every length from 1 to 32, or the sample length of the sensor scenarios.
+    uint8_t AckLength;      // 0 = no ACK payloads, 255 = every length from 1 to 32.
+    uint8_t LossPercent;
+    uint16_t DurationMillis;
+    uint8_t AddressWidth, CrcLength;
+    uint8_t RadioCount;     // Receiving radios of the gateway, each on its own channel, destinations, nodes, or hops.
+};
+
+const static Scenario SCENARIOS[] = {
+    { "polling",                POLLING,            NRFLite::REQUIRE_ACK, 32,   0,  0, 500, 5, 1, 1 },
+    { "interrupts",             INTERRUPTS,         NRFLite::REQUIRE_ACK, 32,   0,  0, 500, 5, 1, 1 },
+    { "polling_no_ack",         POLLING,            NRFLite::NO_ACK,      32,   0,  0, 500, 5, 1, 1 },
+    { "interrupts_no_ack",      INTERRUPTS,         NRFLite::NO_ACK,      32,   0,  0, 500, 5, 1, 1 },
+    { "polling_ack_payload",    POLLING,            NRFLite::REQUIRE_ACK, 32,  32,  0, 500, 5, 1, 1 },
+    { "interrupts_ack_payload", INTERRUPTS,         NRFLite::REQUIRE_ACK, 32,  32,  0, 500, 5, 1, 1 },
+    { "polling_10pct_loss",     POLLING,            NRFLite::REQUIRE_ACK, 32,   0, 10, 500, 5, 1, 1 },
+    { "polling_packet_size",    POLLING,            NRFLite::REQUIRE_ACK,  0,   0,  0, 200, 5, 1, 1 },
+    { "polling_ack_size",       POLLING,            NRFLite::REQUIRE_ACK, 32, 255,  0, 200, 5, 1, 1 },
+    { "request_response",       REQUEST_RESPONSE,   NRFLite::REQUIRE_ACK, 32,   0,  0, 500, 5, 1, 1 },
+    { "polling_8_bytes",        POLLING,            NRFLite::REQUIRE_ACK,  8,   0,  0, 500, 5, 1, 1 },
+    { "polling_8_bytes_aw4",    POLLING,            NRFLite::REQUIRE_ACK,  8,   0,  0, 500, 4, 1, 1 },
+    { "polling_8_bytes_aw3",    POLLING,            NRFLite::REQUIRE_ACK,  8,   0,  0, 500, 3, 1, 1 },
+    { "polling_8_bytes_crc2",   POLLING,            NRFLite::REQUIRE_ACK,  8,   0,  0, 500, 5, 2, 1 },
+    { "beacon",                 BEACON,             NRFLite::NO_ACK,      32,   0,  0, 500, 5, 1, 1 },
+    { "gateway_1_radio",        GATEWAY,            NRFLite::REQUIRE_ACK, 32,   0,  0, 500, 5, 1, 1 },
+    { "gateway_2_radios",       GATEWAY,            NRFLite::REQUIRE_ACK, 32,   0,  0, 500, 5, 1, 2 },
+    { "gateway_3_radios",       GATEWAY,            NRFLite::REQUIRE_ACK, 32,   0,  0, 500, 5, 1, 3 },
+    { "destinations_send",      DESTINATIONS_SEND,  NRFLite::REQUIRE_ACK,  8,   0,  0, 500, 5, 1, 4 },
+    { "destinations_queue",     DESTINATIONS_QUEUE, NRFLite::REQUIRE_ACK,  8,   0,  0, 500, 5, 1, 4 },
+    { "uplink_aloha_4_nodes",   UPLINK_ALOHA,       NRFLite::REQUIRE_ACK, 32,   0,  0, 500, 5, 1, 4 },
+    { "uplink_tdma_4_nodes",    UPLINK_TDMA,        NRFLite::REQUIRE_ACK, 32,   0,  0, 500, 5, 1, 4 },
+    { "uplink_aloha_8_nodes",   UPLINK_ALOHA,       NRFLite::REQUIRE_ACK, 32,   0,  0, 500, 5, 1, 8 },
+    { "uplink_tdma_8_nodes",    UPLINK_TDMA,        NRFLite::REQUIRE_ACK, 32,   0,  0, 500, 5, 1, 8 },
+    { "uplink_aloha_16_nodes",  UPLINK_ALOHA,       NRFLite::REQUIRE_ACK, 32,   0,  0, 500, 5, 1, 16 },
+    { "uplink_tdma_16_nodes",   UPLINK_TDMA,        NRFLite::REQUIRE_ACK, 32,   0,  0, 500, 5, 1, 16 },
+    { "uplink_aloha_22_nodes",  UPLINK_ALOHA,       NRFLite::REQUIRE_ACK, 32,   0,  0, 500, 5, 1, 22 },
+    { "uplink_tdma_22_nodes",   UPLINK_TDMA,        NRFLite::REQUIRE_ACK, 32,   0,  0, 500, 5, 1, 22 },
+    { "routing_1_hop",          ROUTING,            NRFLite::REQUIRE_ACK, 27,   0,  0, 500, 5, 1, 1 },
+    { "routing_2_hops",         ROUTING,            NRFLite::REQUIRE_ACK, 27,   0,  0, 500, 5, 1, 2 },
+    { "routing_4_hops",         ROUTING,            NRFLite::REQUIRE_ACK, 27,   0,  0, 500, 5, 1, 4 },
+    { "routing_4_hops_no_ack",  ROUTING,            NRFLite::NO_ACK,      27,   0,  0, 500, 5, 1, 4 },
+    { "routing_4_hops_10pct",   ROUTING,            NRFLite::REQUIRE_ACK, 27,   0, 10, 500, 5, 1, 4 },
+    { "sensor_2_bytes",         SENSOR_SEND,        NRFLite::REQUIRE_ACK,  2,   0,  0, 2000, 5, 1, 1 },
+    { "sensor_2_bytes_batched", SENSOR_BATCH,       NRFLite::REQUIRE_ACK,  2,   0,  0, 2000, 5, 1, 1 },
+    { "sensor_4_bytes",         SENSOR_SEND,        NRFLite::REQUIRE_ACK,  4,   0,  0, 2000, 5, 1, 1 },
+    { "sensor_4_bytes_batched", SENSOR_BATCH,       NRFLite::REQUIRE_ACK,  4,   0,  0, 2000, 5, 1, 1 },
+    { "streamer",               STREAMER,           NRFLite::REQUIRE_ACK, 32,   0,  0, 500, 5, 1, 1 },
+    { "streamer_40_bytes",      STREAMER,           NRFLite::REQUIRE_ACK, 40,   0,  0, 500, 5, 1, 1 },
+    { "streamer_no_ack",        STREAMER,           NRFLite::NO_ACK,      32,   0,  0, 500, 5, 1, 1 },
+    { "message_1kb",            MESSAGE,            NRFLite::REQUIRE_ACK, 32,   0,  0, 500, 5, 1, 1 },
+    { "message_1kb_send",       MESSAGE_SEND,       NRFLite::REQUIRE_ACK, 32,   0,  0, 500, 5, 1, 1 },
+    { "message_1kb_10pct_loss", MESSAGE,            NRFLite::REQUIRE_ACK, 32,   0, 10, 500, 5, 1, 1 },
+    { "message_1kb_send_10pct_loss", MESSAGE_SEND,  NRFLite::REQUIRE_ACK, 32,   0, 10, 500, 5, 1, 1 },
+    { "message_1kb_overflow",   MESSAGE_OVERFLOW,   NRFLite::REQUIRE_ACK, 32,   0,  0, 500, 5, 1, 1 },
+    { "link_adapter",           LINK_ADAPTER,       NRFLite::REQUIRE_ACK, 32,   0,  0, 500, 5, 1, 1 },
+    { "link_adapter_10pct_loss", LINK_ADAPTER,      NRFLite::REQUIRE_ACK, 32,   0, 10, 500, 5, 1, 1 },
+    { "link_adapter_ack_payload", LINK_ADAPTER,     NRFLite::REQUIRE_ACK, 32,  32,  0, 500, 5, 1, 1 },
+};
+
+const static NRFLite::Bitrates BITRATES[] = { NRFLite::BITRATE250KBPS, NRFLite::BITRATE1MBPS, NRFLite::BITRATE2MBPS };
+const static char* BITRATE_NAMES[] = { "250KBPS", "1MBPS", "2MBPS" };
+
+struct Result {
+    const char* Scenario;
+    const char* Bitrate;
+    const char* Pins;
+    uint8_t PacketLength, AckLength;
+    uint32_t Packets;
+    float SuccessPercent, BitsPerSecond, TxSpiBytesPerPacket, RxSpiBytesPerPacket;
+    uint32_t SendP50Micros, SendP99Micros;
+    float TxOnMicrosPerPacket;
+};
+
+NRFLite _txRadio, _rxRadio;
+uint8_t _txRadioNumber, _rxRadioNumber;
+uint16_t _checkFailures;
+
+// Checks behaviour the results depend on.  A failed check is printed and makes the benchmark exit with 1.
+void check(uint8_t isTrue, const char* description)
+{
+    if (isTrue) { return; }
+    fprintf(stderr, "Check failed: %s\n", description);
+    _checkFailures++;
+}
+
+// Settings of the scenario being run, shared with the receiving program.
+NRFLite::Bitrates _bitrate;
+uint8_t _addressWidth, _crcLength;
+uint8_t _usesInterrupts, _ackLength, _rxRadioIsInitialized;
+uint8_t _rxCePin;
+uint32_t _rxPacketCount;
+
+// Program of the receiving microcontroller, like RX_Tests.
+void receiveAndAck()
+{
+    uint8_t packet[32];
+    _rxRadio.readData(packet);
+    _rxPacketCount++;
+
+    if (_ackLength > 0) {
+        uint8_t ack[32] = { 0 };
+        _rxRadio.addAckData(ack, _ackLength);
+    }
+}
+
+void receiverTask()
+{
+    if (!_rxRadioIsInitialized) {
+        _rxRadio.init(RX_RADIO_ID, _rxCePin, PIN_RX_RADIO_CSN, _bitrate, 100, _addressWidth, _crcLength);
+        _rxRadio.hasData(); // Start listening.
+        _rxRadioIsInitialized = 1;
+        return;
+    }
+
+    if (_usesInterrupts) {
+        if (!emuIrqAsserted(_rxRadioNumber)) { return; }
+        uint8_t txOk, txFail, rxReady;
+        _rxRadio.whatHappened(txOk, txFail, rxReady);
+        while (_rxRadio.hasDataISR()) { receiveAndAck(); }
+    }
+    else {
+        while (_rxRadio.hasData()) { receiveAndAck(); }
+    }
+}
+
+// Programs of the sensors sending to the gateway, each on its own microcontroller and channel.
+NRFLite _gatewayRadios[MAX_GATEWAY_RADIOS], _sensorRadios[MAX_GATEWAY_RADIOS];
+uint8_t _gatewayRadioNumbers[MAX_GATEWAY_RADIOS], _sensorRadioNumbers[MAX_GATEWAY_RADIOS];
+NRFLiteAsyncSender* _sensorSenders;
+uint8_t _sensorCePins[MAX_GATEWAY_RADIOS], _sensorIsInitialized[MAX_GATEWAY_RADIOS], _sensorIsSending[MAX_GATEWAY_RADIOS];
+uint32_t _sensorSendStartMicros[MAX_GATEWAY_RADIOS];
+uint8_t _sensorPacket[32], _sensorPacketLength;
+NRFLite::SendType _sensorSendType;
+uint32_t _sensorPacketCount;
+std::vector<uint32_t> _sensorSendMicros;
+
+// Remote programs cannot wait on their radio, since it only moves on between their runs, so the sensors send with
+// NRFLiteAsyncSender and start the next packet as soon as the last one completes.
+template<uint8_t SENSOR>
+void sensorTask()
+{
+    NRFLite& radio = _sensorRadios[SENSOR];
+    NRFLiteAsyncSender& sender = _sensorSenders[SENSOR];
+
+    if (!_sensorIsInitialized[SENSOR]) {
+        radio.init(TX_RADIO_ID + SENSOR, _sensorCePins[SENSOR], PIN_SENSOR_RADIO_CSN[SENSOR], _bitrate,
+                   GATEWAY_CHANNELS[SENSOR], _addressWidth, _crcLength);
+        _sensorIsInitialized[SENSOR] = 1;
+        return;
+    }
+
+    sender.poll();
+    if (sender.isBusy()) { return; }
+
+    if (_sensorIsSending[SENSOR]) {
+        _sensorSendMicros.push_back(micros() - _sensorSendStartMicros[SENSOR]);
+        _sensorPacketCount++;
+    }
+
+    _sensorIsSending[SENSOR] = 1;
+    _sensorSendStartMicros[SENSOR] = micros();
+    sender.submit(RX_RADIO_ID, _sensorPacket, _sensorPacketLength, _sensorSendType);
+}
+
+void (* const SENSOR_TASKS[])() = { sensorTask<0>, sensorTask<1>, sensorTask<2> };
+
+// Programs of the radios the gateway sends commands to, each on its own microcontroller.
+NRFLite _destinationRadios[MAX_DESTINATIONS];
+uint8_t _destinationRadioNumbers[MAX_DESTINATIONS], _destinationIsInitialized[MAX_DESTINATIONS];
+uint8_t _destinationCePins[MAX_DESTINATIONS];
+
+template<uint8_t DESTINATION>
+void destinationTask()
+{
+    NRFLite& radio = _destinationRadios[DESTINATION];
+
+    if (!_destinationIsInitialized[DESTINATION]) {
+        radio.init(DESTINATION_RADIO_ID + DESTINATION, _destinationCePins[DESTINATION],
+                   PIN_DESTINATION_RADIO_CSN[DESTINATION], _bitrate, 100, _addressWidth, _crcLength);
+        radio.hasData(); // Start listening.
+        _destinationIsInitialized[DESTINATION] = 1;
+        return;
+    }
+
+    uint8_t packet[32];
+    while (radio.hasData()) { radio.readData(packet); _rxPacketCount++; }
+}
+
+void (* const DESTINATION_TASKS[])() = { destinationTask<0>, destinationTask<1>, destinationTask<2>, destinationTask<3> };
+
+// Programs of the nodes sending to one receiver, each on its own microcontroller.  Like the sensors, they start the next
+// packet as soon as the last one completes, but each packet holds the node's radio id and a count.  Otherwise packets
+// from different nodes with the same packet id would look like retries of each other to the receiver, which discards
+// them.  The receiver uses the count to skip packets it already has.  Without TDMA, nodes pause for a random time
+// before each packet, as programs sharing a channel would, and are given random retry delays, since nodes retrying
+// after the same delay collide on every retry.
+NRFLite _nodeRadios[MAX_NODES];
+uint8_t _nodeRadioNumbers[MAX_NODES], _nodeIsInitialized[MAX_NODES], _nodeIsSending[MAX_NODES];
+uint32_t _nodeSendStartMicros[MAX_NODES], _nodePauseStartMicros[MAX_NODES];
+uint16_t _nodePacketCounts[MAX_NODES], _nodeReceivedCounts[MAX_NODES];
+uint32_t _nodePauseMicros[MAX_NODES], _nodeMaxPauseMicros;
+uint32_t _nodeRandomState;
+NRFLiteAsyncSender* _nodeAsyncSenders[MAX_NODES];
+NRFLiteTdmaSender* _nodeTdmaSenders[MAX_NODES];
+uint8_t _nodesUseTdma;
+
+// xorshift, separate from the packet loss of the emulator so the other scenarios are not changed.
+uint32_t getNodeRandom()
+{
+    _nodeRandomState ^= _nodeRandomState << 13;
+    _nodeRandomState ^= _nodeRandomState >> 17;
+    _nodeRandomState ^= _nodeRandomState << 5;
+    return _nodeRandomState;
+}
+
+// Returns 0 for a packet the receiver already has from the node.  Each node sends one packet at a time, so a copy
+// always follows the packet it repeats.
+uint8_t isNewNodePacket(const uint8_t* packet)
+{
+    uint8_t node = packet[0] - TX_RADIO_ID;
+    uint16_t count = packet[1] | packet[2] << 8;
+    if (node >= MAX_NODES || count == _nodeReceivedCounts[node]) { return 0; }
+    _nodeReceivedCounts[node] = count;
+    return 1;
+}
+
+template<uint8_t NODE>
+void nodeTask()
+{
+    NRFLite& radio = _nodeRadios[NODE];
+    NRFLiteAsyncSender& asyncSender = *_nodeAsyncSenders[NODE];
+    NRFLiteTdmaSender& tdmaSender = *_nodeTdmaSenders[NODE];
+
+    if (!_nodeIsInitialized[NODE]) {
+        radio.init(TX_RADIO_ID + NODE, PIN_NODE_RADIO_CE + NODE, PIN_NODE_RADIO_CSN + NODE, _bitrate, 100,
+                   _addressWidth, _crcLength);
+        if (_nodesUseTdma) {
+            tdmaSender.begin(RX_RADIO_ID);
+        }
+        else {
+            // Between the retry delay set by 'init' and the longest of 4000 uS.
+            uint8_t initDelaySteps = _bitrate == NRFLite::BITRATE250KBPS ? 6 : 2;
+            radio.setRetries(initDelaySteps + getNodeRandom() % (17 - initDelaySteps), 15);
+        }
+        _nodeIsInitialized[NODE] = 1;
+        return;
+    }
+
+    if (_nodesUseTdma) {
+        tdmaSender.update();
+        if (tdmaSender.isBusy()) { return; }
+    }
+    else {
+        asyncSender.poll();
+        if (asyncSender.isBusy()) { return; }
+    }
+
+    if (_nodeIsSending[NODE]) {
+        _sensorSendMicros.push_back(micros() - _nodeSendStartMicros[NODE]);
+        _sensorPacketCount++;
+        _nodeIsSending[NODE] = 0;
+        _nodePauseStartMicros[NODE] = micros();
+        _nodePauseMicros[NODE] = _nodesUseTdma ? 0 : getNodeRandom() % _nodeMaxPauseMicros;
+    }
+
+    if (micros() - _nodePauseStartMicros[NODE] < _nodePauseMicros[NODE]) { return; }
+
+    uint8_t packet[32];
+    memcpy(packet, _sensorPacket, _sensorPacketLength);
+    packet[0] = TX_RADIO_ID + NODE;
+    packet[1] = (uint8_t)_nodePacketCounts[NODE];
+    packet[2] = (uint8_t)(_nodePacketCounts[NODE]++ >> 8);
+
+    _nodeIsSending[NODE] = 1;
+    _nodeSendStartMicros[NODE] = micros();
+
+    if (_nodesUseTdma) { tdmaSender.send(packet, _sensorPacketLength); }
+    else               { asyncSender.submit(RX_RADIO_ID, packet, _sensorPacketLength, _sensorSendType); }
+}
+
+void (* const NODE_TASKS[])() = {
+    nodeTask<0>,  nodeTask<1>,  nodeTask<2>,  nodeTask<3>,  nodeTask<4>,  nodeTask<5>,  nodeTask<6>,  nodeTask<7>,
+    nodeTask<8>,  nodeTask<9>,  nodeTask<10>, nodeTask<11>, nodeTask<12>, nodeTask<13>, nodeTask<14>, nodeTask<15>,
+    nodeTask<16>, nodeTask<17>, nodeTask<18>, nodeTask<19>, nodeTask<20>, nodeTask<21>
+};
+
+// Programs of the radio sending along the chain and of the radios relaying its packets, each on its own microcontroller.
+// The source queues a packet every 10 ms, like a sensor reporting, with the time it was queued so the receiver can find
+// the latency.  The emulator has one clock for every microcontroller.
+typedef NRFLiteRouter<1, 4> Router;
+NRFLite _hopRadios[MAX_HOPS];
+uint8_t _hopRadioNumbers[MAX_HOPS], _hopIsInitialized[MAX_HOPS], _hopCount;
+Router* _hopRouters[MAX_HOPS];
+uint32_t _sourceSendMicros;
+
+template<uint8_t HOP>
+void hopTask()
+{
+    NRFLite& radio = _hopRadios[HOP];
+    Router& router = *_hopRouters[HOP];
+
+    if (!_hopIsInitialized[HOP]) {
+        radio.init(HOP_RADIO_ID + HOP, PIN_HOP_RADIO_CE + HOP, PIN_HOP_RADIO_CSN + HOP, _bitrate, 100,
+                   _addressWidth, _crcLength);
+        uint8_t nextHopId = HOP + 1 < _hopCount ? HOP_RADIO_ID + HOP + 1 : RX_RADIO_ID;
+        router.addRoute(RX_RADIO_ID, nextHopId, _sensorSendType);
+        _hopIsInitialized[HOP] = 1;
+        return;
+    }
+
+    uint8_t packet[32];
+    while (router.hasData()) { router.readData(packet); } // Only the receiver at the end of the chain gets packets.
+
+    uint32_t currentMicros = micros();
+    if (HOP > 0 || currentMicros - _sourceSendMicros < SOURCE_INTERVAL_MICROS) { return; }
+
+    _sourceSendMicros = currentMicros;
+    memcpy(packet, _sensorPacket, _sensorPacketLength);
+    memcpy(packet, &currentMicros, sizeof(currentMicros));
+    if (router.send(RX_RADIO_ID, packet, _sensorPacketLength)) { _sensorPacketCount++; }
+}
+
+void (* const HOP_TASKS[])() = { hopTask<0>, hopTask<1>, hopTask<2>, hopTask<3> };
+
+// Program of the microcontroller receiving the samples of the sensor scenarios.  Each sample starts with its index,
+// which gives the time it was taken.
+uint8_t _samplesAreBatched;
+uint32_t _sampleStartMicros;
+
+void receiveSample(uint8_t* sample)
+{
+    uint16_t index;
+    memcpy(&index, sample, sizeof(index));
+    _sensorSendMicros.push_back(micros() - (_sampleStartMicros + index * (uint32_t)SAMPLE_INTERVAL_MICROS));
+    _rxPacketCount++;
+}
+
+void sampleReceiverTask()
+{
+    if (!_rxRadioIsInitialized) {
+        _rxRadio.init(RX_RADIO_ID, _rxCePin, PIN_RX_RADIO_CSN, _bitrate, 100, _addressWidth, _crcLength);
+        _rxRadio.hasData(); // Start listening.
+        _rxRadioIsInitialized = 1;
+        return;
+    }
+
+    uint8_t packet[32], sample[32], length;
+
+    while ((length = _rxRadio.hasData()) > 0) {
+        _rxRadio.readData(packet);
+
+        if (_samplesAreBatched) {
+            NRFLiteBatchReader reader;
+            reader.begin(packet, length);
+            while (reader.read(sample)) { receiveSample(sample); }
+        }
+        else {
+            receiveSample(packet);
+        }
+    }
+}
+
+// Program of the microcontroller receiving the messages of the message scenarios.  The first byte of each message is
+// its number, and the others follow a pattern that starts from it.
+NRFLiteMessageReceiver _messageReceiver(_rxRadio);
+uint8_t _receivedMessage[MESSAGE_LENGTH];
+uint16_t _receivedMessageMaxLength;
+
+void fillMessage(uint8_t* message, uint8_t number)
+{
+    for (uint16_t i = 0; i < MESSAGE_LENGTH; i++) { message[i] = number + i * 7; }
+}
+
+void messageReceiverTask()
+{
+    if (!_rxRadioIsInitialized) {
+        _rxRadio.init(RX_RADIO_ID, _rxCePin, PIN_RX_RADIO_CSN, _bitrate, 100, _addressWidth, _crcLength);
+        _messageReceiver.begin(_receivedMessage, _receivedMessageMaxLength);
+        _rxRadio.hasData(); // Start listening.
+        _rxRadioIsInitialized = 1;
+        return;
+    }
+
+    uint16_t length = _messageReceiver.receiveMessage();
+    if (length == 0) { return; }
+
+    uint8_t message[MESSAGE_LENGTH];
+    fillMessage(message, _receivedMessage[0]);
+    check(length == MESSAGE_LENGTH && memcmp(message, _receivedMessage, MESSAGE_LENGTH) == 0,
+          "A message is received with the data sent");
+    _rxPacketCount++;
+}
+
+// IRQ pin handler of the transmitting microcontroller, like TX_Tests.
+void txRadioInterrupt()
+{
+    uint8_t txOk, txFail, rxReady;
+    _txRadio.whatHappened(txOk, txFail, rxReady);
+
+    if (txOk) {
+        uint8_t ack[32];
+        while (_txRadio.hasAckData()) { _txRadio.readData(ack); }
+    }
+}
+
+// Both programs for the request and response scenario, run on one microcontroller.  Returns the round trip time and
+// counts the reply in '_rxPacketCount' when it arrives.
+uint32_t sendRequestAndReply(uint8_t* packet, uint8_t length)
+{
+    uint32_t startMicros = micros();
+    uint8_t data[32];
+
+    if (!_txRadio.send(RX_RADIO_ID, packet, length)) { return micros() - startMicros; }
+    _txRadio.hasData(); // Start listening for the reply.
+
+    while (!_rxRadio.hasData()) {
+        if (micros() - startMicros > REPLY_TIMEOUT_MICROS) { return micros() - startMicros; }
+    }
+
+    _rxRadio.readData(data);
+    _rxRadio.send(TX_RADIO_ID, data, length);
+    _rxRadio.hasData(); // Start listening for the next request.
+
+    while (!_txRadio.hasData()) {
+        if (micros() - startMicros > REPLY_TIMEOUT_MICROS) { return micros() - startMicros; }
+    }
+
+    _txRadio.readData(data);
+    _rxPacketCount++;
+    return micros() - startMicros;
+}
+
+uint32_t getPercentile(std::vector<uint32_t>& values, uint8_t percent)
+{
+    if (values.empty()) { return 0; }
+    std::sort(values.begin(), values.end());
+    size_t rank = (values.size() * percent + 99) / 100; // Nearest rank.
+    return values[rank > 0 ? rank - 1 : 0];
+}
+
+Result runScenario(const Scenario& scenario, uint8_t bitrateIndex, uint8_t sharedPins, uint8_t packetLength, uint8_t ackLength)
+{
+    uint8_t txCePin = sharedPins ? PIN_TX_RADIO_CSN : PIN_TX_RADIO_CE;
+    _rxCePin = sharedPins ? PIN_RX_RADIO_CSN : PIN_RX_RADIO_CE;
+    _bitrate = BITRATES[bitrateIndex];
+    _addressWidth = scenario.AddressWidth;
+    _crcLength = scenario.CrcLength;
+    _usesInterrupts = scenario.Mode == INTERRUPTS;
+    _ackLength = ackLength;
+    _rxRadioIsInitialized = 0;
+
+    emuReset(1);
+    emuSetPacketLoss(scenario.LossPercent);
+    _txRadioNumber = emuAddRadio(txCePin, PIN_TX_RADIO_CSN);
+
+    if (scenario.Mode == REQUEST_RESPONSE) {
+        _rxRadioNumber = emuAddRadio(_rxCePin, PIN_RX_RADIO_CSN);
+        _rxRadio.init(RX_RADIO_ID, _rxCePin, PIN_RX_RADIO_CSN, _bitrate, 100, _addressWidth, _crcLength);
+        _rxRadio.hasData();
+    }
+    else {
+        _rxRadioNumber = emuAddRemoteRadio(_rxCePin, PIN_RX_RADIO_CSN, receiverTask, RECEIVER_LOOP_MICROS);
+    }
+
+    _txRadio.init(TX_RADIO_ID, txCePin, PIN_TX_RADIO_CSN, _bitrate, 100, _addressWidth, _crcLength);
+    if (scenario.Mode == INTERRUPTS) { emuAttachInterrupt(_txRadioNumber, txRadioInterrupt); }
+    delay(WARM_UP_MILLIS);
+
+    uint8_t packet[40]; // Longer than a packet for the streamer scenario that writes 40 bytes.
+    for (uint8_t i = 0; i < sizeof(packet); i++) { packet[i] = i; }
+
+    NRFLiteBeacon beacon(_txRadio);
+    if (scenario.Mode == BEACON) { beacon.begin(RX_RADIO_ID, packet, packetLength); }
+
+    NRFLiteStreamer streamer(_txRadio);
+    if (scenario.Mode == STREAMER) { streamer.begin(RX_RADIO_ID, scenario.SendType); }
+
+    NRFLiteLinkAdapter adapter(_txRadio, ackLength);
+
+    std::vector<uint32_t> sendMicros;
+    uint32_t packets = 0;
+    _rxPacketCount = 0;
+    uint32_t txSpiBytes = emuGetSpiBytes(_txRadioNumber);
+    uint32_t rxSpiBytes = emuGetSpiBytes(_rxRadioNumber);
+    uint32_t startMicros = micros();
+    uint32_t durationMicros = scenario.DurationMillis * 1000UL;
+
+    while (micros() - startMicros < durationMicros) {
+
+        uint32_t sendStartMicros = micros();
+
+        if (scenario.Mode == REQUEST_RESPONSE) {
+            sendMicros.push_back(sendRequestAndReply(packet, packetLength));
+        }
+        else if (scenario.Mode == BEACON) {
+            if (!beacon.send()) { continue; }
+            sendMicros.push_back(micros() - sendStartMicros);
+        }
+        else if (scenario.Mode == INTERRUPTS) {
+            _txRadio.startSend(RX_RADIO_ID, packet, packetLength, scenario.SendType);
+            sendMicros.push_back(micros() - sendStartMicros);
+        }
+        else if (scenario.Mode == STREAMER) {
+            streamer.write(packet, packetLength);
+            sendMicros.push_back(micros() - sendStartMicros);
+            while (streamer.hasResult()) { streamer.readResult(); }
+        }
+        else {
+            if (scenario.Mode == LINK_ADAPTER) { adapter.send(RX_RADIO_ID, packet, packetLength, scenario.SendType); }
+            else { _txRadio.send(RX_RADIO_ID, packet, packetLength, scenario.SendType); }
+            sendMicros.push_back(micros() - sendStartMicros);
+
+            uint8_t ack[32];
+            while (_txRadio.hasAckData()) { _txRadio.readData(ack); }
+        }
+
+        packets++;
+    }
+
+    if (scenario.Mode == STREAMER) { streamer.end(); }
+
+    uint32_t elapsedMicros = micros() - startMicros;
+    emuDetachInterrupt(_txRadioNumber);
+    beacon.end();
+    uint8_t sentLength = packetLength > 32 ? 32 : packetLength;
+
+    Result result;
+    result.Scenario = scenario.Name;
+    result.Bitrate = BITRATE_NAMES[bitrateIndex];
+    result.Pins = sharedPins ? "shared" : "separate";
+    result.PacketLength = packetLength;
+    result.AckLength = ackLength;
+    result.Packets = packets;
+    result.SuccessPercent = packets ? _rxPacketCount * 100.0f / packets : 0;
+    result.BitsPerSecond = _rxPacketCount * sentLength * 8 * 1000000.0f / elapsedMicros;
+    result.TxSpiBytesPerPacket = packets ? (emuGetSpiBytes(_txRadioNumber) - txSpiBytes) / (float)packets : 0;
+    result.RxSpiBytesPerPacket = _rxPacketCount ? (emuGetSpiBytes(_rxRadioNumber) - rxSpiBytes) / (float)_rxPacketCount : 0;
+    result.SendP50Micros = getPercentile(sendMicros, 50);
+    result.SendP99Micros = getPercentile(sendMicros, 99);
+    result.TxOnMicrosPerPacket = 0;
+    return result;
+}
+
+uint32_t getSpiBytes(const uint8_t* radioNumbers, uint8_t radioCount)
+{
+    uint32_t bytes = 0;
+    for (uint8_t i = 0; i < radioCount; i++) { bytes += emuGetSpiBytes(radioNumbers[i]); }
+    return bytes;
+}
+
+// One microcontroller with several radios on the same SPI bus, each listening on its own channel to a sensor that
+// sends packets as fast as it can.  Per packet results are for all the radios together.
+Result runGatewayScenario(const Scenario& scenario, uint8_t bitrateIndex, uint8_t sharedPins, uint8_t packetLength)
+{
+    _bitrate = BITRATES[bitrateIndex];
+    _addressWidth = scenario.AddressWidth;
+    _crcLength = scenario.CrcLength;
+    _sensorPacketLength = packetLength;
+    _sensorSendType = scenario.SendType;
+
+    NRFLiteAsyncSender senders[] = {
+        NRFLiteAsyncSender(_sensorRadios[0]), NRFLiteAsyncSender(_sensorRadios[1]), NRFLiteAsyncSender(_sensorRadios[2])
+    };
+    _sensorSenders = senders;
+
+    emuReset(1);
+    emuSetPacketLoss(scenario.LossPercent);
+
+    // The sensors are added first so they start up while the gateway radios do.
+    for (uint8_t i = 0; i < scenario.RadioCount; i++) {
+        _sensorCePins[i] = sharedPins ? PIN_SENSOR_RADIO_CSN[i] : PIN_SENSOR_RADIO_CE[i];
+        _sensorIsInitialized[i] = 0;
+        _sensorIsSending[i] = 0;
+        _sensorRadioNumbers[i] = emuAddRemoteRadio(_sensorCePins[i], PIN_SENSOR_RADIO_CSN[i], SENSOR_TASKS[i],
+                                                   RECEIVER_LOOP_MICROS);
+    }
+
+    for (uint8_t i = 0; i < scenario.RadioCount; i++) {
+        uint8_t gatewayCePin = sharedPins ? PIN_GATEWAY_RADIO_CSN[i] : PIN_GATEWAY_RADIO_CE[i];
+        _gatewayRadioNumbers[i] = emuAddRadio(gatewayCePin, PIN_GATEWAY_RADIO_CSN[i]);
+        _gatewayRadios[i].init(RX_RADIO_ID, gatewayCePin, PIN_GATEWAY_RADIO_CSN[i], _bitrate, GATEWAY_CHANNELS[i],
+                               _addressWidth, _crcLength);
+        _gatewayRadios[i].hasData(); // Start listening.
+    }
+
+    delay(WARM_UP_MILLIS);
+
+    // Packets received during the warm up are not counted.
+    uint8_t packet[32];
+    for (uint8_t i = 0; i < scenario.RadioCount; i++) {
+        while (_gatewayRadios[i].hasData()) { _gatewayRadios[i].readData(packet); }
+    }
+
+    uint32_t txSpiBytes = getSpiBytes(_sensorRadioNumbers, scenario.RadioCount);
+    uint32_t rxSpiBytes = getSpiBytes(_gatewayRadioNumbers, scenario.RadioCount);
+
+    _sensorSendMicros.clear();
+    _sensorPacketCount = 0;
+    _rxPacketCount = 0;
+    uint32_t startMicros = micros();
+    uint32_t durationMicros = scenario.DurationMillis * 1000UL;
+
+    while (micros() - startMicros < durationMicros) {
+        for (uint8_t i = 0; i < scenario.RadioCount; i++) {
+            while (_gatewayRadios[i].hasData()) { _gatewayRadios[i].readData(packet); _rxPacketCount++; }
+        }
+    }
+
+    uint32_t elapsedMicros = micros() - startMicros;
+
+    txSpiBytes = getSpiBytes(_sensorRadioNumbers, scenario.RadioCount) - txSpiBytes;
+    rxSpiBytes = getSpiBytes(_gatewayRadioNumbers, scenario.RadioCount) - rxSpiBytes;
+
+    Result result;
+    result.Scenario = scenario.Name;
+    result.Bitrate = BITRATE_NAMES[bitrateIndex];
+    result.Pins = sharedPins ? "shared" : "separate";
+    result.PacketLength = packetLength;
+    result.AckLength = 0;
+    result.Packets = _sensorPacketCount;
+    result.SuccessPercent = _sensorPacketCount ? _rxPacketCount * 100.0f / _sensorPacketCount : 0;
+    result.BitsPerSecond = _rxPacketCount * packetLength * 8 * 1000000.0f / elapsedMicros;
+    result.TxSpiBytesPerPacket = _sensorPacketCount ? txSpiBytes / (float)_sensorPacketCount : 0;
+    result.RxSpiBytesPerPacket = _rxPacketCount ? rxSpiBytes / (float)_rxPacketCount : 0;
+    result.SendP50Micros = getPercentile(_sensorSendMicros, 50);
+    result.SendP99Micros = getPercentile(_sensorSendMicros, 99);
+    result.TxOnMicrosPerPacket = 0;
+    return result;
+}
+
+// A gateway with packets for several radios, in turn for each of them, sending them all before checking for data
+// again.  DESTINATIONS_SEND calls 'send' for each packet and 'hasData' in between, as a program handling each command
+// as it comes would, while DESTINATIONS_QUEUE adds them to NRFLiteTxQueue and calls 'update'.  Send times are for each
+// round of packets.
+Result runDestinationsScenario(const Scenario& scenario, uint8_t bitrateIndex, uint8_t sharedPins, uint8_t packetLength)
+{
+    uint8_t txCePin = sharedPins ? PIN_TX_RADIO_CSN : PIN_TX_RADIO_CE;
+    _bitrate = BITRATES[bitrateIndex];
+    _addressWidth = scenario.AddressWidth;
+    _crcLength = scenario.CrcLength;
+
+    emuReset(1);
+    emuSetPacketLoss(scenario.LossPercent);
+    _txRadioNumber = emuAddRadio(txCePin, PIN_TX_RADIO_CSN);
+
+    for (uint8_t i = 0; i < scenario.RadioCount; i++) {
+        _destinationCePins[i] = sharedPins ? PIN_DESTINATION_RADIO_CSN[i] : PIN_DESTINATION_RADIO_CE[i];
+        _destinationIsInitialized[i] = 0;
+        _destinationRadioNumbers[i] = emuAddRemoteRadio(_destinationCePins[i], PIN_DESTINATION_RADIO_CSN[i],
+                                                        DESTINATION_TASKS[i], RECEIVER_LOOP_MICROS);
+    }
+
+    _txRadio.init(TX_RADIO_ID, txCePin, PIN_TX_RADIO_CSN, _bitrate, 100, _addressWidth, _crcLength);
+    delay(WARM_UP_MILLIS);
+
+    uint8_t packet[32];
+    for (uint8_t i = 0; i < sizeof(packet); i++) { packet[i] = i; }
+
+    NRFLiteTxQueue<ROUND_PACKETS> queue(_txRadio);
+    std::vector<uint32_t> sendMicros;
+    uint32_t packets = 0;
+    _rxPacketCount = 0;
+    uint32_t txSpiBytes = emuGetSpiBytes(_txRadioNumber);
+    uint32_t rxSpiBytes = getSpiBytes(_destinationRadioNumbers, scenario.RadioCount);
+    uint32_t startMicros = micros();
+    uint32_t durationMicros = scenario.DurationMillis * 1000UL;
+
+    while (micros() - startMicros < durationMicros) {
+
+        uint32_t sendStartMicros = micros();
+
+        for (uint8_t i = 0; i < ROUND_PACKETS; i++) {
+
+            uint8_t toRadioId = DESTINATION_RADIO_ID + i % scenario.RadioCount;
+
+            if (scenario.Mode == DESTINATIONS_QUEUE) {
+                queue.add(toRadioId, packet, packetLength, 0, 0, scenario.SendType);
+            }
+            else {
+                _txRadio.send(toRadioId, packet, packetLength, scenario.SendType);
+                _txRadio.hasData();
+            }
+        }
+
+        if (scenario.Mode == DESTINATIONS_QUEUE) { queue.update(); }
+
+        sendMicros.push_back(micros() - sendStartMicros);
+        packets += ROUND_PACKETS;
+    }
+
+    uint32_t elapsedMicros = micros() - startMicros;
+
+    Result result;
+    result.Scenario = scenario.Name;
+    result.Bitrate = BITRATE_NAMES[bitrateIndex];
+    result.Pins = sharedPins ? "shared" : "separate";
+    result.PacketLength = packetLength;
+    result.AckLength = 0;
+    result.Packets = packets;
+    result.SuccessPercent = packets ? _rxPacketCount * 100.0f / packets : 0;
+    result.BitsPerSecond = _rxPacketCount * packetLength * 8 * 1000000.0f / elapsedMicros;
+    result.TxSpiBytesPerPacket = packets ? (emuGetSpiBytes(_txRadioNumber) - txSpiBytes) / (float)packets : 0;
+    result.RxSpiBytesPerPacket = _rxPacketCount ?
+        (getSpiBytes(_destinationRadioNumbers, scenario.RadioCount) - rxSpiBytes) / (float)_rxPacketCount : 0;
+    result.SendP50Micros = getPercentile(sendMicros, 50);
+    result.SendP99Micros = getPercentile(sendMicros, 99);
+    result.TxOnMicrosPerPacket = 0;
+    return result;
+}
+
+// Many nodes sending to one receiver on the same channel.  UPLINK_ALOHA nodes send whenever they have a packet, with
+// the radio's automatic retries, and UPLINK_TDMA nodes send in the slots of the receiver's NRFLiteTdmaReceiver.
+Result runUplinkScenario(const Scenario& scenario, uint8_t bitrateIndex, uint8_t sharedPins, uint8_t packetLength)
+{
+    _rxCePin = sharedPins ? PIN_RX_RADIO_CSN : PIN_RX_RADIO_CE;
+    _bitrate = BITRATES[bitrateIndex];
+    _addressWidth = scenario.AddressWidth;
+    _crcLength = scenario.CrcLength;
+    _sensorPacketLength = packetLength;
+    _sensorSendType = scenario.SendType;
+    _nodesUseTdma = scenario.Mode == UPLINK_TDMA;
+    _nodeRandomState = 2463534242UL;
+
+    // 130 uS to enter TX mode, the packet, 130 uS for the receiver to enter TX mode, and the ACK packet.
+    uint8_t byteMicros = _bitrate == NRFLite::BITRATE2MBPS ? 4 : _bitrate == NRFLite::BITRATE1MBPS ? 8 : 32;
+    uint16_t frameMicros = ((1 + _addressWidth + _crcLength) * 8 + 9) * byteMicros / 8;
+    uint16_t exchangeMicros = 260 + 2 * frameMicros + packetLength * byteMicros;
+    _nodeMaxPauseMicros = (uint32_t)NODE_PAUSE_PACKETS * scenario.RadioCount * exchangeMicros;
+
+    emuReset(1);
+    emuSetPacketLoss(scenario.LossPercent);
+
+    for (uint8_t i = 0; i < scenario.RadioCount; i++) {
+        _nodeAsyncSenders[i] = new NRFLiteAsyncSender(_nodeRadios[i]);
+        _nodeTdmaSenders[i] = new NRFLiteTdmaSender(_nodeRadios[i]);
+        _nodeIsInitialized[i] = 0;
+        _nodeIsSending[i] = 0;
+        _nodePacketCounts[i] = 0;
+        _nodeReceivedCounts[i] = 0xFFFF;
+        _nodePauseMicros[i] = 0;
+        _nodeRadioNumbers[i] = emuAddRemoteRadio(PIN_NODE_RADIO_CE + i, PIN_NODE_RADIO_CSN + i, NODE_TASKS[i],
+                                                 RECEIVER_LOOP_MICROS + i); // Not all in step, as on hardware.
+    }
+
+    _rxRadioNumber = emuAddRadio(_rxCePin, PIN_RX_RADIO_CSN);
+    _rxRadio.init(RX_RADIO_ID, _rxCePin, PIN_RX_RADIO_CSN, _bitrate, 100, _addressWidth, _crcLength);
+
+    NRFLiteTdmaReceiver tdmaReceiver(_rxRadio);
+    uint8_t packet[32];
+
+    // Packets received while the nodes start, and join the frame, are not counted.
+    uint32_t warmUpStartMillis = millis();
+
+    if (_nodesUseTdma) {
+        tdmaReceiver.begin(scenario.RadioCount, packetLength);
+
+        while (tdmaReceiver.getNodeCount() < scenario.RadioCount && millis() - warmUpStartMillis < JOIN_TIMEOUT_MILLIS) {
+            while (tdmaReceiver.hasData()) { tdmaReceiver.readData(packet); isNewNodePacket(packet); }
+        }
+    }
+    else {
+        while (millis() - warmUpStartMillis < WARM_UP_MILLIS) {
+            while (_rxRadio.hasData()) { _rxRadio.readData(packet); isNewNodePacket(packet); }
+        }
+    }
+
+    uint32_t txSpiBytes = getSpiBytes(_nodeRadioNumbers, scenario.RadioCount);
+    uint32_t rxSpiBytes = emuGetSpiBytes(_rxRadioNumber);
+
+    _sensorSendMicros.clear();
+    _sensorPacketCount = 0;
+    _rxPacketCount = 0;
+    uint32_t startMicros = micros();
+    uint32_t durationMicros = scenario.DurationMillis * 1000UL;
+
+    while (micros() - startMicros < durationMicros) {
+        if (_nodesUseTdma) {
+            while (tdmaReceiver.hasData()) { tdmaReceiver.readData(packet); _rxPacketCount += isNewNodePacket(packet); }
+        }
+        else {
+            while (_rxRadio.hasData()) { _rxRadio.readData(packet); _rxPacketCount += isNewNodePacket(packet); }
+        }
+    }
+
+    uint32_t elapsedMicros = micros() - startMicros;
+
+    txSpiBytes = getSpiBytes(_nodeRadioNumbers, scenario.RadioCount) - txSpiBytes;
+    rxSpiBytes = emuGetSpiBytes(_rxRadioNumber) - rxSpiBytes;
+    uint32_t sentPacketCount = _sensorPacketCount;
+
+    for (uint8_t i = 0; i < scenario.RadioCount; i++) {
+        if (_nodeIsSending[i] && _nodeReceivedCounts[i] == (uint16_t)(_nodePacketCounts[i] - 1)) { sentPacketCount++; }
+        delete _nodeAsyncSenders[i];
+        delete _nodeTdmaSenders[i];
+    }
+
+    Result result;
+    result.Scenario = scenario.Name;
+    result.Bitrate = BITRATE_NAMES[bitrateIndex];
+    result.Pins = sharedPins ? "shared" : "separate";
+    result.PacketLength = packetLength;
+    result.AckLength = 0;
+    result.Packets = _sensorPacketCount;
+    result.SuccessPercent = sentPacketCount ? _rxPacketCount * 100.0f / sentPacketCount : 0;
+    result.BitsPerSecond = _rxPacketCount * packetLength * 8 * 1000000.0f / elapsedMicros;
+    result.TxSpiBytesPerPacket = _sensorPacketCount ? txSpiBytes / (float)_sensorPacketCount : 0;
+    result.RxSpiBytesPerPacket = _rxPacketCount ? rxSpiBytes / (float)_rxPacketCount : 0;
+    result.SendP50Micros = getPercentile(_sensorSendMicros, 50);
+    result.SendP99Micros = getPercentile(_sensorSendMicros, 99);
+    result.TxOnMicrosPerPacket = 0;
+    return result;
+}
+
+Result runRoutingScenario(const Scenario& scenario, uint8_t bitrateIndex, uint8_t sharedPins, uint8_t packetLength)
+{
+    _rxCePin = sharedPins ? PIN_RX_RADIO_CSN : PIN_RX_RADIO_CE;
+    _bitrate = BITRATES[bitrateIndex];
+    _addressWidth = scenario.AddressWidth;
+    _crcLength = scenario.CrcLength;
+    _sensorPacketLength = packetLength;
+    _sensorSendType = scenario.SendType;
+    _hopCount = scenario.RadioCount;
+
+    emuReset(1);
+    emuSetPacketLoss(scenario.LossPercent);
+    _sourceSendMicros = micros();
+
+    for (uint8_t i = 0; i < _hopCount; i++) {
+        _hopRouters[i] = new Router(_hopRadios[i], HOP_RADIO_ID + i);
+        _hopIsInitialized[i] = 0;
+        _hopRadioNumbers[i] = emuAddRemoteRadio(PIN_HOP_RADIO_CE + i, PIN_HOP_RADIO_CSN + i, HOP_TASKS[i],
+                                                RECEIVER_LOOP_MICROS + i);
+    }
+
+    _rxRadioNumber = emuAddRadio(_rxCePin, PIN_RX_RADIO_CSN);
+    _rxRadio.init(RX_RADIO_ID, _rxCePin, PIN_RX_RADIO_CSN, _bitrate, 100, _addressWidth, _crcLength);
+
+    Router router(_rxRadio, RX_RADIO_ID);
+    uint8_t packet[32];
+
+    // Packets received while the radios start are not counted.
+    uint32_t warmUpStartMillis = millis();
+    while (millis() - warmUpStartMillis < WARM_UP_MILLIS) {
+        while (router.hasData()) { router.readData(packet); }
+    }
+
+    uint32_t txSpiBytes = getSpiBytes(_hopRadioNumbers, _hopCount);
+    uint32_t rxSpiBytes = emuGetSpiBytes(_rxRadioNumber);
+
+    _sensorSendMicros.clear();
+    _sensorPacketCount = 0;
+    _rxPacketCount = 0;
+    uint32_t startMicros = micros();
+    uint32_t durationMicros = scenario.DurationMillis * 1000UL;
+
+    while (micros() - startMicros < durationMicros) {
+        while (router.hasData()) {
+            router.readData(packet);
+            uint32_t sendStartMicros;
+            memcpy(&sendStartMicros, packet, sizeof(sendStartMicros));
+            if ((int32_t)(sendStartMicros - startMicros) < 0) { continue; } // Queued during the warm-up.
+            _sensorSendMicros.push_back(micros() - sendStartMicros);
+            _rxPacketCount++;
+        }
+    }
+
+    uint32_t elapsedMicros = micros() - startMicros;
+
+    txSpiBytes = getSpiBytes(_hopRadioNumbers, _hopCount) - txSpiBytes;
+    rxSpiBytes = emuGetSpiBytes(_rxRadioNumber) - rxSpiBytes;
+
+    for (uint8_t i = 0; i < _hopCount; i++) { delete _hopRouters[i]; }
+
+    Result result;
+    result.Scenario = scenario.Name;
+    result.Bitrate = BITRATE_NAMES[bitrateIndex];
+    result.Pins = sharedPins ? "shared" : "separate";
+    result.PacketLength = packetLength;
+    result.AckLength = 0;
+    result.Packets = _sensorPacketCount;
+    result.SuccessPercent = _sensorPacketCount ? _rxPacketCount * 100.0f / _sensorPacketCount : 0;
+    result.BitsPerSecond = _rxPacketCount * packetLength * 8 * 1000000.0f / elapsedMicros;
+    result.TxSpiBytesPerPacket = _sensorPacketCount ? txSpiBytes / (float)_sensorPacketCount : 0;
+    result.RxSpiBytesPerPacket = _rxPacketCount ? rxSpiBytes / (float)_rxPacketCount : 0;
+    result.SendP50Micros = getPercentile(_sensorSendMicros, 50);
+    result.SendP99Micros = getPercentile(_sensorSendMicros, 99);
+    result.TxOnMicrosPerPacket = 0;
+    return result;
+}
+
+// A sensor on the transmitting microcontroller takes a sample every 10 ms and powers its radio down between sends,
+// sending each sample on its own or adding it to a batch.  It checks the batch between samples, like a program calling
+// 'update' on every pass through 'loop'.
+Result runSensorScenario(const Scenario& scenario, uint8_t bitrateIndex, uint8_t sharedPins, uint8_t sampleLength)
+{
+    uint8_t txCePin = sharedPins ? PIN_TX_RADIO_CSN : PIN_TX_RADIO_CE;
+    _rxCePin = sharedPins ? PIN_RX_RADIO_CSN : PIN_RX_RADIO_CE;
+    _bitrate = BITRATES[bitrateIndex];
+    _addressWidth = scenario.AddressWidth;
+    _crcLength = scenario.CrcLength;
+    _samplesAreBatched = scenario.Mode == SENSOR_BATCH;
+    _rxRadioIsInitialized = 0;
+
+    emuReset(1);
+    emuSetPacketLoss(scenario.LossPercent);
+    _txRadioNumber = emuAddRadio(txCePin, PIN_TX_RADIO_CSN);
+    _rxRadioNumber = emuAddRemoteRadio(_rxCePin, PIN_RX_RADIO_CSN, sampleReceiverTask, RECEIVER_LOOP_MICROS);
+
+    _txRadio.init(TX_RADIO_ID, txCePin, PIN_TX_RADIO_CSN, _bitrate, 100, _addressWidth, _crcLength);
+    _txRadio.powerDown();
+    delay(WARM_UP_MILLIS);
+
+    NRFLiteBatchSender batchSender(_txRadio);
+    batchSender.begin(RX_RADIO_ID, BATCH_MAX_AGE_MILLIS, scenario.SendType);
+
+    uint8_t sample[32] = { 0 };
+    uint32_t durationMicros = scenario.DurationMillis * 1000UL;
+    uint16_t samples = durationMicros / SAMPLE_INTERVAL_MICROS;
+    uint16_t sampleCount = 0;
+
+    _sensorSendMicros.clear();
+    _rxPacketCount = 0;
+    uint32_t txSpiBytes = emuGetSpiBytes(_txRadioNumber);
+    uint32_t rxSpiBytes = emuGetSpiBytes(_rxRadioNumber);
+    uint32_t txOnMicros = emuGetPoweredUpMicros(_txRadioNumber);
+    _sampleStartMicros = micros();
+
+    while (sampleCount < samples) {
+
+        if (micros() - _sampleStartMicros < sampleCount * (uint32_t)SAMPLE_INTERVAL_MICROS) {
+            if (_samplesAreBatched) { batchSender.update(); }
+            continue;
+        }
+
+        memcpy(sample, &sampleCount, sizeof(sampleCount));
+        sampleCount++;
+
+        if (_samplesAreBatched) {
+            batchSender.add(sample, sampleLength);
+        }
+        else {
+            _txRadio.send(RX_RADIO_ID, sample, sampleLength, scenario.SendType);
+            _txRadio.powerDown();
+        }
+    }
+
+    // The last samples are sent and the receiver given the rest of the time to read them.
+    batchSender.flush();
+    while (micros() - _sampleStartMicros < durationMicros) {}
+
+    uint32_t elapsedMicros = micros() - _sampleStartMicros;
+    txOnMicros = emuGetPoweredUpMicros(_txRadioNumber) - txOnMicros;
+
+    Result result;
+    result.Scenario = scenario.Name;
+    result.Bitrate = BITRATE_NAMES[bitrateIndex];
+    result.Pins = sharedPins ? "shared" : "separate";
+    result.PacketLength = sampleLength;
+    result.AckLength = 0;
+    result.Packets = samples;
+    result.SuccessPercent = _rxPacketCount * 100.0f / samples;
+    result.BitsPerSecond = _rxPacketCount * sampleLength * 8 * 1000000.0f / elapsedMicros;
+    result.TxSpiBytesPerPacket = (emuGetSpiBytes(_txRadioNumber) - txSpiBytes) / (float)samples;
+    result.RxSpiBytesPerPacket = _rxPacketCount ? (emuGetSpiBytes(_rxRadioNumber) - rxSpiBytes) / (float)_rxPacketCount : 0;
+    result.SendP50Micros = getPercentile(_sensorSendMicros, 50);
+    result.SendP99Micros = getPercentile(_sensorSendMicros, 99);
+    result.TxOnMicrosPerPacket = txOnMicros / (float)samples;
+    return result;
+}
+
+// Sends a message one fragment at a time with 'send', using the fragment header of NRFLiteMessageSender, like the
+// hand-written loops that NRFLiteMessageSender replaces.  Returns 0 if a fragment fails too many times in a row.
+uint8_t sendMessageFragments(const uint8_t* message, uint8_t messageId)
+{
+    const uint8_t fragmentDataLength = 29;
+    uint16_t fragmentCount = (MESSAGE_LENGTH + fragmentDataLength - 1) / fragmentDataLength;
+
+    for (uint16_t fragment = 0; fragment < fragmentCount; fragment++) {
+
+        uint16_t dataOffset = fragment * fragmentDataLength;
+        uint8_t dataLength = MESSAGE_LENGTH - dataOffset < fragmentDataLength ? MESSAGE_LENGTH - dataOffset : fragmentDataLength;
+        uint16_t fragmentNumber = fragment == fragmentCount - 1 ? fragment | 0x8000 : fragment;
+
+        uint8_t packet[32];
+        packet[0] = messageId;
+        packet[1] = fragmentNumber;
+        packet[2] = fragmentNumber >> 8;
+        memcpy(packet + 3, message + dataOffset, dataLength);
+
+        uint8_t failures = 0;
+        while (!_txRadio.send(RX_RADIO_ID, packet, dataLength + 3)) {
+            if (++failures == MAX_FRAGMENT_FAILURES) { return 0; }
+        }
+
+        uint8_t ack[32];
+        while (_txRadio.hasAckData()) { _txRadio.readData(ack); }
+    }
+
+    return 1;
+}
+
+// The transmitting microcontroller sends messages to NRFLiteMessageReceiver one after another.
+Result runMessageScenario(const Scenario& scenario, uint8_t bitrateIndex, uint8_t sharedPins, uint8_t packetLength)
+{
+    uint8_t txCePin = sharedPins ? PIN_TX_RADIO_CSN : PIN_TX_RADIO_CE;
+    _rxCePin = sharedPins ? PIN_RX_RADIO_CSN : PIN_RX_RADIO_CE;
+    _bitrate = BITRATES[bitrateIndex];
+    _addressWidth = scenario.AddressWidth;
+    _crcLength = scenario.CrcLength;
+    _receivedMessageMaxLength = scenario.Mode == MESSAGE_OVERFLOW ? OVERFLOW_BUFFER_LENGTH : MESSAGE_LENGTH;
+    _rxRadioIsInitialized = 0;
+
+    emuReset(1);
+    emuSetPacketLoss(scenario.LossPercent);
+    _txRadioNumber = emuAddRadio(txCePin, PIN_TX_RADIO_CSN);
+    _rxRadioNumber = emuAddRemoteRadio(_rxCePin, PIN_RX_RADIO_CSN, messageReceiverTask, RECEIVER_LOOP_MICROS);
+
+    _txRadio.init(TX_RADIO_ID, txCePin, PIN_TX_RADIO_CSN, _bitrate, 100, _addressWidth, _crcLength);
+    delay(WARM_UP_MILLIS);
+
+    NRFLiteMessageSender sender(_txRadio);
+    uint8_t message[MESSAGE_LENGTH];
+
+    if (scenario.Mode != MESSAGE_SEND) {
+        std::vector<uint8_t> longMessage(32769);
+        check(!sender.sendMessage(RX_RADIO_ID, &longMessage[0], longMessage.size()), "sendMessage rejects messages over 32 KB");
+    }
+
+    std::vector<uint32_t> sendMicros;
+    uint32_t messages = 0;
+    _rxPacketCount = 0;
+    uint32_t txSpiBytes = emuGetSpiBytes(_txRadioNumber);
+    uint32_t rxSpiBytes = emuGetSpiBytes(_rxRadioNumber);
+    uint32_t startMicros = micros();
+    uint32_t durationMicros = scenario.DurationMillis * 1000UL;
+
+    while (micros() - startMicros < durationMicros) {
+
+        fillMessage(message, messages);
+        uint32_t receivedCount = _rxPacketCount;
+        uint32_t sendStartMicros = micros();
+
+        if (scenario.Mode == MESSAGE_SEND) {
+            sendMessageFragments(message, messages);
+        }
+        else {
+            uint8_t isSent = sender.sendMessage(RX_RADIO_ID, message, MESSAGE_LENGTH);
+
+            // The receiver confirms the last fragment only after it has completed the message.
+            check(!isSent || _rxPacketCount > receivedCount, "sendMessage only succeeds for messages that were received");
+            if (scenario.Mode == MESSAGE_OVERFLOW) {
+                check(!isSent, "sendMessage fails for a message that does not fit in the receiver's buffer");
+            }
+        }
+
+        sendMicros.push_back(micros() - sendStartMicros);
+        messages++;
+    }
+
+    // 'send' returns once the last fragment is acknowledged, before the receiver may have read it, so the receiver is
+    // given time to complete the last message.
+    uint32_t elapsedMicros = micros() - startMicros;
+    delay(WARM_UP_MILLIS);
+
+    Result result;
+    result.Scenario = scenario.Name;
+    result.Bitrate = BITRATE_NAMES[bitrateIndex];
+    result.Pins = sharedPins ? "shared" : "separate";
+    result.PacketLength = packetLength;
+    result.AckLength = 0;
+    result.Packets = messages;
+    result.SuccessPercent = messages ? _rxPacketCount * 100.0f / messages : 0;
+    result.BitsPerSecond = _rxPacketCount * MESSAGE_LENGTH * 8 * 1000000.0f / elapsedMicros;
+    result.TxSpiBytesPerPacket = messages ? (emuGetSpiBytes(_txRadioNumber) - txSpiBytes) / (float)messages : 0;
+    result.RxSpiBytesPerPacket = _rxPacketCount ? (emuGetSpiBytes(_rxRadioNumber) - rxSpiBytes) / (float)_rxPacketCount : 0;
+    result.SendP50Micros = getPercentile(sendMicros, 50);
+    result.SendP99Micros = getPercentile(sendMicros, 99);
+    result.TxOnMicrosPerPacket = 0;
+    return result;
+}
+
+void printResult(const Result& r, uint8_t asJson, uint8_t isFirst)
+{
+    if (asJson) {
+        printf("%s\n  {\"scenario\": \"%s\", \"bitrate\": \"%s\", \"pins\": \"%s\", \"packet_bytes\": %u, \"ack_bytes\": %u, "
+               "\"packets\": %lu, \"success_pct\": %.2f, \"bps\": %.0f, \"tx_spi_bytes_per_packet\": %.2f, "
+               "\"rx_spi_bytes_per_packet\": %.2f, \"send_p50_us\": %lu, \"send_p99_us\": %lu, "
+               "\"tx_on_us_per_packet\": %.2f}",
+               isFirst ? "" : ",", r.Scenario, r.Bitrate, r.Pins, r.PacketLength, r.AckLength,
+               (unsigned long)r.Packets, r.SuccessPercent, r.BitsPerSecond, r.TxSpiBytesPerPacket,
+               r.RxSpiBytesPerPacket, (unsigned long)r.SendP50Micros, (unsigned long)r.SendP99Micros,
+               r.TxOnMicrosPerPacket);
+    }
+    else {
+        printf("%s,%s,%s,%u,%u,%lu,%.2f,%.0f,%.2f,%.2f,%lu,%lu,%.2f\n",
+               r.Scenario, r.Bitrate, r.Pins, r.PacketLength, r.AckLength,
+               (unsigned long)r.Packets, r.SuccessPercent, r.BitsPerSecond, r.TxSpiBytesPerPacket,
+               r.RxSpiBytesPerPacket, (unsigned long)r.SendP50Micros, (unsigned long)r.SendP99Micros,
+               r.TxOnMicrosPerPacket);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint8_t asJson = argc > 1 && strcmp(argv[1], "--json") == 0;
+    uint8_t isFirst = 1;
+
+    if (asJson) {
+        printf("[");
+    }
+    else {
+        printf("scenario,bitrate,pins,packet_bytes,ack_bytes,packets,success_pct,bps,"
+               "tx_spi_bytes_per_packet,rx_spi_bytes_per_packet,send_p50_us,send_p99_us,tx_on_us_per_packet\n");
+    }
+
+    for (uint8_t bitrateIndex = 0; bitrateIndex < 3; bitrateIndex++) {
+        for (uint8_t sharedPins = 0; sharedPins < 2; sharedPins++) {
+            for (uint8_t s = 0; s < sizeof(SCENARIOS) / sizeof(SCENARIOS[0]); s++) {
+
+                const Scenario& scenario = SCENARIOS[s];
+                if (scenario.Mode == BEACON && sharedPins) { continue; } // Beacons need a separate CE pin.
+
+                // The size scenarios produce a result for each length.
+                for (uint8_t length = 1; length <= 32; length++) {
+
+                    uint8_t packetLength = scenario.PacketLength ? scenario.PacketLength : length;
+                    uint8_t ackLength = scenario.AckLength == 255 ? length : scenario.AckLength;
+
+                    if (scenario.Mode == GATEWAY) {
+                        printResult(runGatewayScenario(scenario, bitrateIndex, sharedPins, packetLength), asJson, isFirst);
+                    }
+                    else if (scenario.Mode == DESTINATIONS_SEND || scenario.Mode == DESTINATIONS_QUEUE) {
+                        printResult(runDestinationsScenario(scenario, bitrateIndex, sharedPins, packetLength), asJson, isFirst);
+                    }
+                    else if (scenario.Mode == UPLINK_ALOHA || scenario.Mode == UPLINK_TDMA) {
+                        printResult(runUplinkScenario(scenario, bitrateIndex, sharedPins, packetLength), asJson, isFirst);
+                    }
+                    else if (scenario.Mode == ROUTING) {
+                        printResult(runRoutingScenario(scenario, bitrateIndex, sharedPins, packetLength), asJson, isFirst);
+                    }
+                    else if (scenario.Mode == SENSOR_SEND || scenario.Mode == SENSOR_BATCH) {
+                        printResult(runSensorScenario(scenario, bitrateIndex, sharedPins, packetLength), asJson, isFirst);
+                    }
+                    else if (scenario.Mode == MESSAGE || scenario.Mode == MESSAGE_SEND || scenario.Mode == MESSAGE_OVERFLOW) {
+                        printResult(runMessageScenario(scenario, bitrateIndex, sharedPins, packetLength), asJson, isFirst);
+                    }
+                    else {
+                        printResult(runScenario(scenario, bitrateIndex, sharedPins, packetLength, ackLength), asJson, isFirst);
+                    }
+                    isFirst = 0;
+
+                    if (scenario.PacketLength && scenario.AckLength != 255) { break; }
+                }
+            }
+        }
+    }
+
+    if (asJson) { printf("\n]\n"); }
+
+    return _checkFailures > 0;
+}
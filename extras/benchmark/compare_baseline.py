@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""Compares benchmark results with a baseline and reports regressions.
+
+    python3 compare_baseline.py baseline.csv results.csv [--tolerance 2]
+
+Each result is matched to the baseline by scenario, bitrate, pins, packet size and ACK size.  A result is a regression
+when its bps drops, its SPI bytes per packet, send latency, or radio on time grows, by more than the tolerance percent,
+or when its success percent drops by more than the tolerance.  The exit code is 1 if there are regressions or results
+are missing, so it can gate changes.  After an intended change, regenerate the baseline with './benchmark > baseline.csv'.
+"""
+
+import argparse
+import csv
+import sys
+
+KEY_COLUMNS = ("scenario", "bitrate", "pins", "packet_bytes", "ack_bytes")
+
+# Column, True if higher is better.
+METRICS = (
+    ("bps", True),
+    ("tx_spi_bytes_per_packet", False),
+    ("rx_spi_bytes_per_packet", False),
+    ("send_p50_us", False),
+    ("send_p99_us", False),
+    ("tx_on_us_per_packet", False),
+)
+
+
+def read_results(path):
+    with open(path, newline="") as file:
+        return {tuple(row[column] for column in KEY_COLUMNS): row for row in csv.DictReader(file)}
+
+
+def percent_change(old, new):
+    if old == 0:
+        return 0.0 if new == 0 else float("inf")
+    return (new - old) * 100.0 / old
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare NRFLite benchmark results with a baseline.")
+    parser.add_argument("baseline")
+    parser.add_argument("results")
+    parser.add_argument("--tolerance", type=float, default=2.0, help="allowed change in percent (default 2)")
+    args = parser.parse_args()
+
+    baseline = read_results(args.baseline)
+    results = read_results(args.results)
+    regressions, improvements = [], []
+
+    missing = [key for key in baseline if key not in results]
+    for key in missing:
+        print("missing   %s" % " ".join(key))
+
+    for key, result in results.items():
+        if key not in baseline:
+            print("new       %s" % " ".join(key))
+            continue
+
+        base = baseline[key]
+        name = " ".join(key)
+
+        for column, higher_is_better in METRICS:
+            change = percent_change(float(base[column]), float(result[column]))
+            worse = -change if higher_is_better else change
+            line = "%-60s %-24s %10s -> %-10s %+.1f%%" % (name, column, base[column], result[column], change)
+            if worse > args.tolerance:
+                regressions.append(line)
+            elif worse < -args.tolerance:
+                improvements.append(line)
+
+        drop = float(base["success_pct"]) - float(result["success_pct"])
+        line = "%-60s %-24s %10s -> %-10s %+.2f points" % (name, "success_pct", base["success_pct"], result["success_pct"], -drop)
+        if drop > args.tolerance:
+            regressions.append(line)
+        elif drop < -args.tolerance:
+            improvements.append(line)
+
+    if improvements:
+        print("Improvements (%d)" % len(improvements))
+        print("\n".join(improvements))
+    if regressions:
+        print("Regressions (%d)" % len(regressions))
+        print("\n".join(regressions))
+
+    print("%d results compared, %d regressions, %d improvements, %d missing" %
+          (len(results), len(regressions), len(improvements), len(missing)))
+
+    sys.exit(1 if regressions or missing else 0)
+
+
+if __name__ == "__main__":
+    main()
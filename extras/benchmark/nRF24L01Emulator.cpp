@@ -0,0 +1,761 @@
+#include <nRF24L01Emulator.h>
+#include <NRFLite.h>
+
+const static uint8_t MAX_RADIOS = 32;
+const static uint8_t FIFO_LENGTH = 3;
+const static uint8_t SPI_BYTE_MICROS = 2;
+const static uint8_t PIN_CHANGE_MICROS = 1;
+const static uint8_t MODE_CHANGE_MICROS = 130; // Standby to TX or RX mode, and TX to RX mode for the ACK packet.
+const static uint16_t POWER_UP_MICROS = 1500;  // Power down to Standby-I mode.
+
+struct Packet {
+    uint8_t Length;
+    uint8_t Data[32];
+    uint8_t Pipe;  // RX pipe the packet arrived on, or the pipe an ACK payload is for.
+    uint8_t NoAck;
+    uint8_t Pid;   // Packet id, changed for each new payload so receivers can discard repeats.
+};
+
+struct Fifo {
+    Packet Packets[FIFO_LENGTH];
+    uint8_t Count;
+};
+
+enum TxStates { TX_IDLE, TX_SENDING, TX_RECEIVING_ACK };
+
+struct Radio {
+    uint8_t CePin, CsnPin;
+
+    // Registers.  RX pipes 0 and 1 and TX have 5 byte addresses, RX pipes 2-5 keep their 1 byte in 'Registers'.
+    uint8_t Registers[32];
+    uint8_t RxAddresses[2][5];
+    uint8_t TxAddress[5];
+
+    Fifo Rx, Tx;
+    uint8_t IsReusingTx, NextPid;
+
+    // Power up and RX mode settling.
+    uint64_t StandbyMicros, ListeningMicros;
+    uint8_t IsEnteringRx;
+    uint64_t PowerUpStartMicros, PoweredUpMicros; // When PWR_UP was last set, and the time it was set before then.
+
+    // Transmission in progress.
+    TxStates TxState;
+    uint64_t TxEventMicros;
+    uint8_t TxRetries, HasAckPayload;
+    Packet AckPayload;
+    Radio* AckingRadio;
+    uint64_t AckStartMicros;
+
+    // Last 2 times the radio was on the air, sending a packet or an ACK packet, to find collisions.
+    uint64_t AirStartMicros[2], AirEndMicros[2];
+    uint8_t AirIndex;
+
+    // Last packet requiring an ACK received on each pipe, to discard retransmissions of it.
+    uint8_t HasLastRx[6], LastRxPid[6];
+    uint16_t LastRxChecksum[6];
+
+    // SPI transaction in progress.
+    uint8_t Command[33];
+    uint8_t CommandLength;
+    uint32_t SpiBytes, SpiTransactions;
+
+    // Programs using the radio.
+    void (*InterruptHandler)();
+    uint8_t IrqWasAsserted, InterruptIsPending;
+    void (*Task)();
+    uint16_t TaskIntervalMicros;
+    uint64_t NextTaskMicros, DeafUntilMicros;
+    uint8_t CeWasPulsed;   // Set when a remote program raised CE, which it may have lowered before its task ended.
+};
+
+static Radio _radios[MAX_RADIOS];
+static uint8_t _radioCount;
+static uint8_t _pins[256];
+static uint64_t _micros;           // Clock of the microcontroller running the program.
+static Radio* _localSpiRadio;      // Radio in an SPI transaction with this microcontroller.
+static Radio* _remoteRadio;        // Radio whose remote program is running.
+static uint32_t _remoteMicros, _remoteSpiMicros;
+static uint8_t _packetLossPercent;
+static uint8_t _channelActivity[126];
+static uint8_t _isUpdating, _isRunningPrograms;
+static uint32_t _randomState;
+
+Stream Serial;
+
+static void advance(uint32_t micros);
+
+//////////////////////////////
+// Packets and FIFO buffers //
+//////////////////////////////
+
+static void fifoPush(Fifo& fifo, const Packet& packet)
+{
+    if (fifo.Count < FIFO_LENGTH) { fifo.Packets[fifo.Count++] = packet; }
+}
+
+static void fifoRemove(Fifo& fifo, uint8_t index)
+{
+    for (uint8_t i = index + 1; i < fifo.Count; i++) { fifo.Packets[i - 1] = fifo.Packets[i]; }
+    fifo.Count--;
+}
+
+static uint16_t getChecksum(const Packet& packet)
+{
+    uint16_t checksum = packet.Length;
+    for (uint8_t i = 0; i < packet.Length; i++) { checksum = (checksum << 1 | checksum >> 15) ^ packet.Data[i]; }
+    return checksum;
+}
+
+// xorshift, so runs repeat exactly on every platform.
+static uint8_t randomPercent()
+{
+    _randomState ^= _randomState << 13;
+    _randomState ^= _randomState >> 17;
+    _randomState ^= _randomState << 5;
+    return _randomState % 100;
+}
+
+////////////
+// Radios //
+////////////
+
+static uint8_t isCeHigh(Radio& radio) { return _pins[radio.CePin]; }
+static uint8_t isPoweredUp(Radio& radio) { return radio.Registers[CONFIG] & _BV(PWR_UP); }
+static uint8_t isRxMode(Radio& radio) { return isPoweredUp(radio) && (radio.Registers[CONFIG] & _BV(PRIM_RX)); }
+static uint8_t isInStandby(Radio& radio) { return isPoweredUp(radio) && radio.StandbyMicros <= _micros; }
+static uint8_t getAddressLength(Radio& radio) { return (radio.Registers[SETUP_AW] & 0x03) + 2; }
+
+static uint8_t getCrcLength(Radio& radio)
+{
+    if (!(radio.Registers[CONFIG] & _BV(EN_CRC))) { return 0; }
+    return radio.Registers[CONFIG] & _BV(CRCO) ? 2 : 1;
+}
+
+static uint8_t getBitrateSetting(Radio& radio)
+{
+    return radio.Registers[RF_SETUP] & (_BV(RF_DR_LOW) | _BV(RF_DR_HIGH));
+}
+
+static uint32_t getAirtimeMicros(Radio& radio, uint8_t length)
+{
+    // Preamble, address, 9 bit packet control field, payload, and CRC.
+    uint32_t bits = (1 + getAddressLength(radio) + length + getCrcLength(radio)) * 8 + 9;
+    uint8_t bitrate = getBitrateSetting(radio);
+    if (bitrate & _BV(RF_DR_LOW))  { return bits * 4; }
+    if (bitrate & _BV(RF_DR_HIGH)) { return (bits + 1) / 2; }
+    return bits;
+}
+
+static uint8_t getStatus(Radio& radio)
+{
+    uint8_t rxPipe = radio.Rx.Count ? radio.Rx.Packets[0].Pipe : 7;
+    uint8_t status = (radio.Registers[STATUS] & (_BV(RX_DR) | _BV(TX_DS) | _BV(MAX_RT))) | (rxPipe << RX_P_NO);
+    if (radio.Tx.Count == FIFO_LENGTH) { status |= _BV(TX_FULL); }
+    return status;
+}
+
+static uint8_t getFifoStatus(Radio& radio)
+{
+    uint8_t fifoStatus = 0;
+    if (radio.Rx.Count == 0)           { fifoStatus |= _BV(RX_EMPTY); }
+    if (radio.Rx.Count == FIFO_LENGTH) { fifoStatus |= _BV(RX_FULL); }
+    if (radio.Tx.Count == 0)           { fifoStatus |= _BV(TX_EMPTY); }
+    if (radio.Tx.Count == FIFO_LENGTH) { fifoStatus |= _BV(FIFO_FULL); }
+    if (radio.IsReusingTx)             { fifoStatus |= _BV(TX_REUSE); }
+    return fifoStatus;
+}
+
+static uint8_t isIrqAsserted(Radio& radio)
+{
+    // The CONFIG mask bits are in the same positions as the STATUS flags they mask.
+    return radio.Registers[STATUS] & ~radio.Registers[CONFIG] & (_BV(RX_DR) | _BV(TX_DS) | _BV(MAX_RT));
+}
+
+static uint8_t isAddressMatch(Radio& receiver, uint8_t pipe, const uint8_t* address, uint8_t addressLength)
+{
+    if (!(receiver.Registers[EN_RXADDR] & _BV(pipe))) { return 0; }
+    if (getAddressLength(receiver) != addressLength) { return 0; }
+
+    uint8_t pipeAddress[5];
+
+    if (pipe < 2) {
+        memcpy(pipeAddress, receiver.RxAddresses[pipe], 5);
+    }
+    else {
+        memcpy(pipeAddress, receiver.RxAddresses[1], 5);
+        pipeAddress[0] = receiver.Registers[RX_ADDR_P0 + pipe];
+    }
+
+    return memcmp(pipeAddress, address, addressLength) == 0;
+}
+
+// Returns the first radio after 'previous' that receives the packet, starting from the first radio if it is NULL.
+static Radio* findReceiver(Radio& transmitter, uint32_t airtimeMicros, uint8_t* pipe, Radio* previous)
+{
+    // The receiver must be listening for the whole packet, from its preamble on.
+    uint64_t startMicros = _micros - airtimeMicros;
+
+    for (uint8_t i = previous ? previous - _radios + 1 : 0; i < _radioCount; i++) {
+
+        Radio& receiver = _radios[i];
+
+        if (&receiver == &transmitter || !isRxMode(receiver) || !isCeHigh(receiver)) { continue; }
+        if (!receiver.IsEnteringRx || receiver.ListeningMicros > startMicros) { continue; }
+        if (receiver.DeafUntilMicros > startMicros) { continue; }
+        if (receiver.Registers[RF_CH] != transmitter.Registers[RF_CH]) { continue; }
+        if (getBitrateSetting(receiver) != getBitrateSetting(transmitter)) { continue; }
+        if (getCrcLength(receiver) != getCrcLength(transmitter)) { continue; }
+
+        for (uint8_t p = 0; p < 6; p++) {
+            if (isAddressMatch(receiver, p, transmitter.TxAddress, getAddressLength(transmitter))) {
+                *pipe = p;
+                return &receiver;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+// Returns 1 if the receiver sends an ACK packet back to the transmitter.
+static uint8_t deliver(Radio& transmitter, Radio& receiver, uint8_t pipe, const Packet& packet, uint8_t requiresAck)
+{
+    if (randomPercent() < _packetLossPercent) { return 0; }
+    if (receiver.Rx.Count == FIFO_LENGTH) { return 0; } // Packets are discarded, and not acknowledged, when the RX FIFO is full.
+
+    uint16_t checksum = getChecksum(packet);
+    uint8_t isRepeat = requiresAck && receiver.HasLastRx[pipe] &&
+                       receiver.LastRxPid[pipe] == packet.Pid && receiver.LastRxChecksum[pipe] == checksum;
+
+    if (!isRepeat) {
+        Packet received = packet;
+        received.Pipe = pipe;
+        fifoPush(receiver.Rx, received);
+        receiver.Registers[STATUS] |= _BV(RX_DR);
+
+        if (requiresAck) {
+            receiver.HasLastRx[pipe] = 1;
+            receiver.LastRxPid[pipe] = packet.Pid;
+            receiver.LastRxChecksum[pipe] = checksum;
+        }
+    }
+
+    if (!requiresAck || !(receiver.Registers[EN_AA] & _BV(pipe))) { return 0; }
+
+    // The first ACK payload loaded for the pipe goes out with the ACK packet.
+    transmitter.HasAckPayload = 0;
+
+    for (uint8_t i = 0; i < receiver.Tx.Count; i++) {
+        if (receiver.Tx.Packets[i].Pipe == pipe) {
+            transmitter.AckPayload = receiver.Tx.Packets[i];
+            transmitter.HasAckPayload = 1;
+            fifoRemove(receiver.Tx, i);
+            break;
+        }
+    }
+
+    return randomPercent() >= _packetLossPercent;
+}
+
+static void finishTransmission(Radio& radio, uint8_t success)
+{
+    radio.TxState = TX_IDLE;
+    radio.Registers[OBSERVE_TX] = (radio.Registers[OBSERVE_TX] & 0xF0) | radio.TxRetries;
+
+    if (success) {
+        if (!radio.IsReusingTx) { fifoRemove(radio.Tx, 0); }
+        radio.Registers[STATUS] |= _BV(TX_DS);
+
+        if (radio.HasAckPayload && radio.Rx.Count < FIFO_LENGTH) {
+            radio.AckPayload.Pipe = 0;
+            fifoPush(radio.Rx, radio.AckPayload);
+            radio.Registers[STATUS] |= _BV(RX_DR);
+        }
+    }
+    else {
+        // The packet stays in the TX FIFO and transmissions stop until MAX_RT is cleared.
+        radio.Registers[STATUS] |= _BV(MAX_RT);
+        uint8_t lostPackets = radio.Registers[OBSERVE_TX] >> PLOS_CNT;
+        if (lostPackets < 15) { radio.Registers[OBSERVE_TX] += 1 << PLOS_CNT; }
+    }
+
+    radio.HasAckPayload = 0;
+}
+
+static void addAirtime(Radio& radio, uint64_t startMicros, uint64_t endMicros)
+{
+    radio.AirIndex ^= 1;
+    radio.AirStartMicros[radio.AirIndex] = startMicros;
+    radio.AirEndMicros[radio.AirIndex] = endMicros;
+}
+
+// Returns 1 if a radio other than the ones given was on the air on the same channel between the times.
+static uint8_t isCollision(Radio& radio, Radio* otherRadio, uint64_t startMicros, uint64_t endMicros)
+{
+    for (uint8_t i = 0; i < _radioCount; i++) {
+
+        Radio& interferer = _radios[i];
+        if (&interferer == &radio || &interferer == otherRadio) { continue; }
+        if (interferer.Registers[RF_CH] != radio.Registers[RF_CH]) { continue; }
+
+        for (uint8_t a = 0; a < 2; a++) {
+            if (interferer.AirStartMicros[a] < endMicros && interferer.AirEndMicros[a] > startMicros) { return 1; }
+        }
+    }
+
+    return 0;
+}
+
+static void retryTransmission(Radio& radio, uint64_t packetEndMicros)
+{
+    uint32_t retryDelayMicros = ((radio.Registers[SETUP_RETR] >> ARD) + 1) * 250;
+    uint8_t retryCount = radio.Registers[SETUP_RETR] & 0x0F;
+    uint32_t airtimeMicros = getAirtimeMicros(radio, radio.Tx.Packets[0].Length);
+
+    radio.HasAckPayload = 0;
+
+    if (radio.TxRetries < retryCount) {
+        radio.TxRetries++;
+        radio.TxState = TX_SENDING;
+        radio.TxEventMicros = packetEndMicros + retryDelayMicros + MODE_CHANGE_MICROS + airtimeMicros;
+        addAirtime(radio, radio.TxEventMicros - airtimeMicros, radio.TxEventMicros);
+    }
+    else {
+        finishTransmission(radio, 0);
+    }
+}
+
+static void updateTransmission(Radio& radio)
+{
+    Packet& packet = radio.Tx.Packets[0];
+    uint8_t requiresAck = !packet.NoAck && (radio.Registers[EN_AA] & _BV(ENAA_P0));
+    uint32_t retryDelayMicros = ((radio.Registers[SETUP_RETR] >> ARD) + 1) * 250;
+
+    if (radio.TxState == TX_RECEIVING_ACK) {
+        // An ACK packet that overlapped another transmission is lost, and the packet is sent again.
+        if (isCollision(radio, radio.AckingRadio, radio.AckStartMicros, radio.TxEventMicros)) {
+            retryTransmission(radio, radio.AckStartMicros - MODE_CHANGE_MICROS);
+        }
+        else {
+            finishTransmission(radio, 1);
+        }
+        return;
+    }
+
+    // The packet has been sent, and is lost if it overlapped another transmission.  Every radio listening on its
+    // address receives it, and the ACK packet from the first one is used.
+    uint8_t pipe;
+    uint32_t airtimeMicros = getAirtimeMicros(radio, packet.Length);
+    uint8_t isCollided = isCollision(radio, NULL, radio.TxEventMicros - airtimeMicros, radio.TxEventMicros);
+    Radio* receiver = NULL;
+    uint8_t isAcked = 0;
+
+    for (Radio* r = NULL; !isCollided && (r = findReceiver(radio, airtimeMicros, &pipe, r)) != NULL; ) {
+        if (deliver(radio, *r, pipe, packet, requiresAck) && !isAcked) {
+            receiver = r;
+            isAcked = 1;
+        }
+    }
+
+    if (!requiresAck) {
+        finishTransmission(radio, 1);
+        return;
+    }
+
+    if (isAcked) {
+        // An ACK packet that takes longer than the retry delay is missed.
+        uint32_t ackMicros = MODE_CHANGE_MICROS + getAirtimeMicros(*receiver, radio.HasAckPayload ? radio.AckPayload.Length : 0);
+        addAirtime(*receiver, radio.TxEventMicros + MODE_CHANGE_MICROS, radio.TxEventMicros + ackMicros);
+
+        if (ackMicros <= retryDelayMicros) {
+            radio.TxState = TX_RECEIVING_ACK;
+            radio.AckingRadio = receiver;
+            radio.AckStartMicros = radio.TxEventMicros + MODE_CHANGE_MICROS;
+            radio.TxEventMicros += ackMicros;
+            return;
+        }
+    }
+
+    retryTransmission(radio, radio.TxEventMicros);
+}
+
+static void updateRadios()
+{
+    for (uint8_t i = 0; i < _radioCount; i++) {
+
+        Radio& radio = _radios[i];
+
+        if (radio.TxState != TX_IDLE && radio.TxEventMicros <= _micros) { updateTransmission(radio); }
+
+        // RX mode is entered when CE is HIGH in Standby-I with PRIM_RX set, and the radio listens 130 uS later.
+        uint8_t isEnteringRx = isInStandby(radio) && isRxMode(radio) && isCeHigh(radio);
+        if (isEnteringRx && !radio.IsEnteringRx) { radio.ListeningMicros = _micros + MODE_CHANGE_MICROS; }
+        radio.IsEnteringRx = isEnteringRx;
+
+        // A transmission starts when CE is HIGH in TX mode and there is a packet to send.
+        uint8_t canTransmit = isInStandby(radio) && !isRxMode(radio) && (isCeHigh(radio) || radio.CeWasPulsed) &&
+                              radio.Tx.Count > 0 && !(radio.Registers[STATUS] & _BV(MAX_RT));
+        radio.CeWasPulsed = 0;
+
+        if (radio.TxState == TX_IDLE && canTransmit) {
+            radio.TxState = TX_SENDING;
+            radio.TxRetries = 0;
+            radio.HasAckPayload = 0;
+            radio.TxEventMicros = _micros + MODE_CHANGE_MICROS + getAirtimeMicros(radio, radio.Tx.Packets[0].Length);
+            addAirtime(radio, _micros + MODE_CHANGE_MICROS, radio.TxEventMicros);
+        }
+
+        uint8_t irqIsAsserted = isIrqAsserted(radio);
+        if (irqIsAsserted && !radio.IrqWasAsserted) { radio.InterruptIsPending = 1; }
+        radio.IrqWasAsserted = irqIsAsserted;
+    }
+}
+
+static void runRemoteProgram(Radio& radio)
+{
+    _remoteRadio = &radio;
+    _remoteMicros = 0;
+    _remoteSpiMicros = 0;
+
+    radio.Task();
+
+    _remoteRadio = NULL;
+
+    // With CE and CSN on the same pin, the radio cannot receive while its program uses SPI, and then needs 130 uS to
+    // enter RX mode again once CE goes back HIGH.
+    if (radio.CePin == radio.CsnPin && _remoteSpiMicros > 0) {
+        radio.DeafUntilMicros = _micros + _remoteSpiMicros + MODE_CHANGE_MICROS;
+    }
+
+    uint32_t intervalMicros = _remoteMicros > radio.TaskIntervalMicros ? _remoteMicros : radio.TaskIntervalMicros;
+    radio.NextTaskMicros = _micros + intervalMicros;
+}
+
+static void runPrograms()
+{
+    // Interrupt handlers and remote programs run between the SPI transactions of this microcontroller.
+    if (_isRunningPrograms || _localSpiRadio) { return; }
+    _isRunningPrograms = 1;
+
+    for (uint8_t i = 0; i < _radioCount; i++) {
+
+        Radio& radio = _radios[i];
+
+        if (radio.Task && radio.NextTaskMicros <= _micros) {
+            runRemoteProgram(radio);
+        }
+
+        if (radio.InterruptHandler && radio.InterruptIsPending) {
+            radio.InterruptIsPending = 0;
+            radio.InterruptHandler();
+        }
+    }
+
+    _isRunningPrograms = 0;
+}
+
+static void advance(uint32_t micros)
+{
+    if (_remoteRadio) {
+        _remoteMicros += micros;
+        if (!_pins[_remoteRadio->CsnPin]) { _remoteSpiMicros += micros; }
+        return;
+    }
+
+    while (micros--) {
+        _micros++;
+
+        if (!_isUpdating) {
+            _isUpdating = 1;
+            updateRadios();
+            _isUpdating = 0;
+        }
+
+        runPrograms();
+    }
+}
+
+//////////////////
+// SPI commands //
+//////////////////
+
+static uint8_t readRegisterByte(Radio& radio, uint8_t reg, uint8_t index)
+{
+    if (reg == STATUS)      { return getStatus(radio); }
+    if (reg == FIFO_STATUS) { return getFifoStatus(radio); }
+    if (reg == TX_ADDR)     { return radio.TxAddress[index % 5]; }
+    if (reg == RX_ADDR_P0 || reg == RX_ADDR_P1) { return radio.RxAddresses[reg - RX_ADDR_P0][index % 5]; }
+
+    if (reg == RPD) {
+        uint8_t channel = radio.Registers[RF_CH] > 125 ? 125 : radio.Registers[RF_CH];
+        return isRxMode(radio) && randomPercent() < _channelActivity[channel];
+    }
+
+    return radio.Registers[reg];
+}
+
+static void writeRegister(Radio& radio, uint8_t reg, const uint8_t* data, uint8_t length)
+{
+    if (length == 0) { return; }
+
+    if (reg == STATUS) {
+        radio.Registers[STATUS] &= ~(data[0] & (_BV(RX_DR) | _BV(TX_DS) | _BV(MAX_RT)));
+    }
+    else if (reg == TX_ADDR) {
+        memcpy(radio.TxAddress, data, length < 5 ? length : 5);
+    }
+    else if (reg == RX_ADDR_P0 || reg == RX_ADDR_P1) {
+        memcpy(radio.RxAddresses[reg - RX_ADDR_P0], data, length < 5 ? length : 5);
+    }
+    else if (reg == CONFIG) {
+        uint8_t isPoweringUp = !isPoweredUp(radio) && (data[0] & _BV(PWR_UP));
+        uint8_t isPoweringDown = isPoweredUp(radio) && !(data[0] & _BV(PWR_UP));
+        radio.Registers[CONFIG] = data[0];
+
+        if (isPoweringUp) {
+            radio.StandbyMicros = _micros + POWER_UP_MICROS;
+            radio.PowerUpStartMicros = _micros;
+        }
+        else if (isPoweringDown) {
+            radio.PoweredUpMicros += _micros - radio.PowerUpStartMicros;
+        }
+    }
+    else if (reg == RF_CH) {
+        radio.Registers[RF_CH] = data[0] & 0x7F;
+        radio.Registers[OBSERVE_TX] &= 0x0F; // Changing the channel resets the lost packet count.
+    }
+    else if (reg != OBSERVE_TX && reg != RPD && reg != FIFO_STATUS) {
+        radio.Registers[reg] = data[0];
+    }
+}
+
+static void runCommand(Radio& radio)
+{
+    if (radio.CommandLength == 0) { return; }
+
+    uint8_t command = radio.Command[0];
+    uint8_t* data = radio.Command + 1;
+    uint8_t dataLength = radio.CommandLength - 1;
+
+    if ((command & 0xE0) == W_REGISTER) {
+        writeRegister(radio, command & REGISTER_MASK, data, dataLength);
+    }
+    else if (command == W_TX_PAYLOAD || command == W_TX_PAYLOAD_NO_ACK || (command & 0xF8) == W_ACK_PAYLOAD) {
+        if (dataLength == 0 || dataLength > 32) { return; }
+
+        Packet packet;
+        packet.Length = dataLength;
+        memcpy(packet.Data, data, dataLength);
+        packet.NoAck = command == W_TX_PAYLOAD_NO_ACK;
+        packet.Pipe = (command & 0xF8) == W_ACK_PAYLOAD ? command & 0x07 : 0;
+        packet.Pid = radio.NextPid++;
+        fifoPush(radio.Tx, packet);
+
+        if ((command & 0xF8) != W_ACK_PAYLOAD) { radio.IsReusingTx = 0; }
+    }
+    else if (command == R_RX_PAYLOAD) {
+        if (radio.Rx.Count) { fifoRemove(radio.Rx, 0); }
+    }
+    else if (command == FLUSH_TX) {
+        radio.Tx.Count = 0;
+        radio.IsReusingTx = 0;
+    }
+    else if (command == FLUSH_RX) {
+        radio.Rx.Count = 0;
+    }
+    else if (command == REUSE_TX_PL) {
+        radio.IsReusingTx = 1;
+    }
+}
+
+static Radio* findRadioByCsn(uint8_t pin)
+{
+    for (uint8_t i = 0; i < _radioCount; i++) {
+        if (_radios[i].CsnPin == pin) { return &_radios[i]; }
+    }
+    return NULL;
+}
+
+///////////////////////
+// NRFLite transport //
+///////////////////////
+
+void nrfliteTransportBegin() {}
+
+void nrfliteTransportPinMode(uint8_t, uint8_t) {}
+
+void nrfliteTransportDigitalWrite(uint8_t pin, uint8_t value)
+{
+    Radio* radio = findRadioByCsn(pin);
+    uint8_t oldValue = _pins[pin];
+    _pins[pin] = value ? HIGH : LOW;
+
+    if (_remoteRadio && pin == _remoteRadio->CePin && value) { _remoteRadio->CeWasPulsed = 1; }
+
+    if (radio && oldValue && !value) {
+        radio->CommandLength = 0;
+        radio->SpiTransactions++;
+        if (!_remoteRadio) { _localSpiRadio = radio; }
+    }
+    else if (radio && !oldValue && value) {
+        runCommand(*radio);
+        if (!_remoteRadio) { _localSpiRadio = NULL; }
+    }
+
+    advance(PIN_CHANGE_MICROS);
+}
+
+uint8_t nrfliteTransportDigitalRead(uint8_t pin)
+{
+    return _pins[pin];
+}
+
+uint8_t nrfliteTransportTransfer(uint8_t data)
+{
+    Radio* radio = _remoteRadio ? _remoteRadio : _localSpiRadio;
+    advance(SPI_BYTE_MICROS);
+
+    if (radio == NULL) { return 0xFF; }
+
+    radio->SpiBytes++;
+    if (radio->CommandLength < sizeof(radio->Command)) { radio->Command[radio->CommandLength] = data; }
+    radio->CommandLength++;
+
+    // The STATUS register is clocked out with the command byte.
+    if (radio->CommandLength == 1) { return getStatus(*radio); }
+
+    uint8_t command = radio->Command[0];
+    uint8_t index = radio->CommandLength - 2;
+
+    if (command < W_REGISTER) { return readRegisterByte(*radio, command & REGISTER_MASK, index); }
+    if (command == R_RX_PL_WID) { return radio->Rx.Count ? radio->Rx.Packets[0].Length : 0; }
+
+    if (command == R_RX_PAYLOAD) {
+        if (radio->Rx.Count == 0 || index >= radio->Rx.Packets[0].Length) { return 0; }
+        return radio->Rx.Packets[0].Data[index];
+    }
+
+    return 0;
+}
+
+////////////////////
+// Arduino timing //
+////////////////////
+
+unsigned long micros()
+{
+    advance(1);
+    return _remoteRadio ? _micros + _remoteMicros : _micros;
+}
+
+unsigned long millis()
+{
+    return micros() / 1000;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    advance(us);
+}
+
+void delay(unsigned long ms)
+{
+    while (ms--) { advance(1000); }
+}
+
+//////////////////////
+// Emulator control //
+//////////////////////
+
+void emuReset(uint32_t seed)
+{
+    memset(_radios, 0, sizeof(_radios));
+    memset(_pins, 0, sizeof(_pins));
+    memset(_channelActivity, 0, sizeof(_channelActivity));
+    _radioCount = 0;
+    _micros = 0;
+    _localSpiRadio = NULL;
+    _remoteRadio = NULL;
+    _packetLossPercent = 0;
+    _randomState = seed ? seed : 1;
+}
+
+uint8_t emuAddRadio(uint8_t cePin, uint8_t csnPin)
+{
+    Radio& radio = _radios[_radioCount];
+
+    memset(&radio, 0, sizeof(Radio));
+    radio.CePin = cePin;
+    radio.CsnPin = csnPin;
+    _pins[csnPin] = HIGH;
+
+    // Reset values from the datasheet.
+    radio.Registers[CONFIG] = _BV(EN_CRC);
+    radio.Registers[EN_AA] = 0x3F;
+    radio.Registers[EN_RXADDR] = _BV(ERX_P0) | _BV(ERX_P1);
+    radio.Registers[SETUP_AW] = 0x03;
+    radio.Registers[SETUP_RETR] = 0x03;
+    radio.Registers[RF_CH] = 2;
+    radio.Registers[RF_SETUP] = 0x0E;
+    radio.Registers[RX_ADDR_P2] = 0xC3;
+    radio.Registers[RX_ADDR_P3] = 0xC4;
+    radio.Registers[RX_ADDR_P4] = 0xC5;
+    radio.Registers[RX_ADDR_P5] = 0xC6;
+    memset(radio.RxAddresses[0], 0xE7, 5);
+    memset(radio.RxAddresses[1], 0xC2, 5);
+    memset(radio.TxAddress, 0xE7, 5);
+
+    return _radioCount++;
+}
+
+uint8_t emuAddRemoteRadio(uint8_t cePin, uint8_t csnPin, void (*task)(), uint16_t intervalMicros)
+{
+    uint8_t number = emuAddRadio(cePin, csnPin);
+    _radios[number].Task = task;
+    _radios[number].TaskIntervalMicros = intervalMicros ? intervalMicros : 1;
+    _radios[number].NextTaskMicros = _micros;
+    return number;
+}
+
+void emuAttachInterrupt(uint8_t radio, void (*handler)())
+{
+    _radios[radio].InterruptHandler = handler;
+    _radios[radio].InterruptIsPending = 0;
+}
+
+void emuDetachInterrupt(uint8_t radio)
+{
+    _radios[radio].InterruptHandler = NULL;
+}
+
+uint8_t emuIrqAsserted(uint8_t radio)
+{
+    return isIrqAsserted(_radios[radio]) ? 1 : 0;
+}
+
+void emuSetPacketLoss(uint8_t percent)
+{
+    _packetLossPercent = percent;
+}
+
+void emuSetChannelActivity(uint8_t channel, uint8_t percent)
+{
+    if (channel < sizeof(_channelActivity)) { _channelActivity[channel] = percent; }
+}
+
+uint32_t emuGetSpiBytes(uint8_t radio)
+{
+    return _radios[radio].SpiBytes;
+}
+
+uint32_t emuGetSpiTransactions(uint8_t radio)
+{
+    return _radios[radio].SpiTransactions;
+}
+
+uint32_t emuGetPoweredUpMicros(uint8_t radio)
+{
+    Radio& r = _radios[radio];
+    return r.PoweredUpMicros + (isPoweredUp(r) ? _micros - r.PowerUpStartMicros : 0);
+}
@@ -0,0 +1,48 @@
+#ifndef _nRF24L01Emulator_h_
+#define _nRF24L01Emulator_h_
+
+#include <Arduino.h>
+
+// Emulates nRF24L01+ radios on a PC so NRFLite can be measured without boards.  The library is compiled with
+// NRFLITE_EXTERNAL_TRANSPORT and this file provides its transport functions along with the Arduino timing functions.
+//
+// Time is simulated.  The microcontroller running the program is charged 2 uS per SPI byte and 1 uS per pin change or
+// call to 'micros' or 'millis', roughly a 16 MHz ATmega with an 8 MHz SPI clock.  Radios follow the timing of the
+// datasheet:  1.5 mS to power up, 130 uS to enter TX or RX mode, the packet airtime for the bitrate, address width,
+// and CRC length, the retry delay and count from SETUP_RETR, and 130 uS plus airtime for the ACK packet.
+//
+// A remote radio belongs to another microcontroller whose program is the task given to 'emuAddRemoteRadio'.  The task
+// runs every 'intervalMicros' and its work is timed on that microcontroller's own clock, so a receiver does not slow
+// down the transmitter being measured.  While a remote program uses SPI with CE and CSN on the same pin, its radio
+// cannot receive, and needs 130 uS to listen again afterwards, as on hardware.  A packet is received by every radio
+// listening on its address for all of its airtime, and a packet or ACK packet that overlaps another transmission on the
+// same channel is lost, so radios sending at the same time collide.  Every radio needs its own CE and CSN pin numbers.
+//
+// Simplifications:  the payload of an ACK packet that is lost is lost with it, RPD only reports the activity set by
+// 'emuSetChannelActivity', and the pin and register changes of a remote program take effect when its task starts,
+// although a CE pulse within the task still starts a transmission.
+//
+// emuReset              = Removes all radios, restarts the clock at 0, and seeds the random number generator used
+//                         for packet loss so runs can be repeated exactly.
+// emuAddRadio           = Adds a radio connected to this microcontroller, returning its number.
+// emuAddRemoteRadio     = Adds a radio connected to another microcontroller running 'task', returning its number.
+// emuAttachInterrupt    = Calls 'handler' when the IRQ pin of the radio goes LOW, between SPI transactions.
+// emuIrqAsserted        = Returns 1 if the IRQ pin of the radio is LOW.
+// emuSetPacketLoss      = Percent of packets and ACK packets lost in the air.
+// emuSetChannelActivity = Percent of the time other devices are transmitting on the channel, seen through RPD.
+// emuGetSpiBytes        = SPI bytes transferred with the radio since it was added.
+// emuGetSpiTransactions = SPI transactions with the radio since it was added.
+// emuGetPoweredUpMicros = Time the radio has had PWR_UP set since it was added, from when it started powering up.
+void     emuReset(uint32_t seed);
+uint8_t  emuAddRadio(uint8_t cePin, uint8_t csnPin);
+uint8_t  emuAddRemoteRadio(uint8_t cePin, uint8_t csnPin, void (*task)(), uint16_t intervalMicros);
+void     emuAttachInterrupt(uint8_t radio, void (*handler)());
+void     emuDetachInterrupt(uint8_t radio);
+uint8_t  emuIrqAsserted(uint8_t radio);
+void     emuSetPacketLoss(uint8_t percent);
+void     emuSetChannelActivity(uint8_t channel, uint8_t percent);
+uint32_t emuGetSpiBytes(uint8_t radio);
+uint32_t emuGetSpiTransactions(uint8_t radio);
+uint32_t emuGetPoweredUpMicros(uint8_t radio);
+
+#endif
@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+"""Decodes the output of NRFLite 'printTrace' into a timeline and latency histograms.
+
+Build the library with NRFLITE_TRACE set to 1 in NRFLite.h, call 'printTrace' from the sketch, save the serial output
+to a file, then run:
+
+    python3 decode_trace.py serial_output.txt
+
+Anything outside the NRFLITE_TRACE and NRFLITE_TRACE_END lines is ignored, so the whole serial log can be used.
+"""
+
+import sys
+
+# Event types, matching the TRACE_ constants in NRFLite.cpp.
+TRACE_CE, TRACE_SPI, TRACE_STATUS, TRACE_CONFIG, TRACE_WAIT, TRACE_THROTTLE = 1, 2, 3, 4, 5, 6
+
+REGISTERS = [
+    "CONFIG", "EN_AA", "EN_RXADDR", "SETUP_AW", "SETUP_RETR", "RF_CH", "RF_SETUP", "STATUS",
+    "OBSERVE_TX", "RPD", "RX_ADDR_P0", "RX_ADDR_P1", "RX_ADDR_P2", "RX_ADDR_P3", "RX_ADDR_P4", "RX_ADDR_P5",
+    "TX_ADDR", "RX_PW_P0", "RX_PW_P1", "RX_PW_P2", "RX_PW_P3", "RX_PW_P4", "RX_PW_P5", "FIFO_STATUS",
+    "0x18", "0x19", "0x1A", "0x1B", "DYNPD", "FEATURE", "0x1E", "0x1F",
+]
+
+COMMANDS = {
+    0x50: "ACTIVATE", 0x60: "R_RX_PL_WID", 0x61: "R_RX_PAYLOAD", 0xA0: "W_TX_PAYLOAD", 0xB0: "W_TX_PAYLOAD_NO_ACK",
+    0xE1: "FLUSH_TX", 0xE2: "FLUSH_RX", 0xE3: "REUSE_TX_PL", 0xFF: "NOP",
+}
+
+TX_PAYLOAD_COMMANDS = (0xA0, 0xB0)
+TX_DS, MAX_RT, RX_DR = 0x20, 0x10, 0x40
+
+
+def read_events(lines):
+    """Returns a list of traces, each a list of (micros, type, value) with micros unwrapped to keep increasing."""
+    traces, events = [], None
+    for line in lines:
+        line = line.strip()
+        if line == "NRFLITE_TRACE":
+            events = []
+        elif line == "NRFLITE_TRACE_END":
+            if events is not None:
+                traces.append(events)
+            events = None
+        elif events is not None:
+            parts = line.split()
+            if len(parts) != 3:
+                continue
+            micros, event_type, value = (int(part, 16) for part in parts)
+            if events:
+                # 'micros' overflows every 71 minutes.
+                last = events[-1][0]
+                micros += last - (last % (1 << 32))
+                if micros < last:
+                    micros += 1 << 32
+            events.append((micros, event_type, value))
+    return traces
+
+
+def describe_spi(command):
+    if command < 0x20:
+        return "read " + REGISTERS[command]
+    if command < 0x40:
+        return "write " + REGISTERS[command - 0x20]
+    if 0xA8 <= command <= 0xAD:
+        return "W_ACK_PAYLOAD pipe %d" % (command - 0xA8)
+    return COMMANDS.get(command, "command 0x%02X" % command)
+
+
+def describe_status(status):
+    flags = [name for name, bit in (("RX_DR", RX_DR), ("TX_DS", TX_DS), ("MAX_RT", MAX_RT)) if status & bit]
+    pipe = (status >> 1) & 7
+    rx_fifo = "RX FIFO empty" if pipe == 7 else "RX pipe %d" % pipe
+    return "STATUS %s, %s" % (" ".join(flags) if flags else "flags clear", rx_fifo)
+
+
+def describe_config(config):
+    if not config & 0x02:
+        mode = "power down"
+    elif config & 0x01:
+        mode = "RX mode"
+    else:
+        mode = "TX mode"
+    return "CONFIG -> " + mode
+
+
+def describe(event_type, value):
+    if event_type == TRACE_CE:
+        return "CE " + ("HIGH" if value else "LOW")
+    if event_type == TRACE_SPI:
+        return "SPI " + describe_spi(value)
+    if event_type == TRACE_STATUS:
+        return describe_status(value)
+    if event_type == TRACE_CONFIG:
+        return describe_config(value)
+    if event_type == TRACE_WAIT:
+        return "wait %d uS" % (value * 16)
+    if event_type == TRACE_THROTTLE:
+        return "hasData throttled, shared CE/CSN pin"
+    return "unknown event %d value 0x%02X" % (event_type, value)
+
+
+def print_timeline(events):
+    start = events[0][0]
+    previous = start
+    print("%10s %8s  %s" % ("time uS", "+uS", "event"))
+    for micros, event_type, value in events:
+        print("%10d %8d  %s" % (micros - start, micros - previous, describe(event_type, value)))
+        previous = micros
+
+
+def print_histogram(title, values):
+    print()
+    print("%s (%d)" % (title, len(values)))
+    if not values:
+        return
+    print("  min %d uS, max %d uS, mean %d uS" % (min(values), max(values), sum(values) // len(values)))
+
+    # Power of 2 buckets.
+    buckets = {}
+    for value in values:
+        bucket = 1
+        while bucket < value:
+            bucket *= 2
+        buckets[bucket] = buckets.get(bucket, 0) + 1
+
+    largest = max(buckets.values())
+    for bucket in sorted(buckets):
+        count = buckets[bucket]
+        print("  <= %7d uS %6d %s" % (bucket, count, "#" * max(1, count * 40 // largest)))
+
+
+def print_latencies(events):
+    tx_latencies, waits = [], []
+    tx_started = None
+    throttles = flushes = 0
+
+    for micros, event_type, value in events:
+        if event_type == TRACE_SPI and value in TX_PAYLOAD_COMMANDS and tx_started is None:
+            tx_started = micros
+        elif event_type == TRACE_STATUS and value & (TX_DS | MAX_RT) and tx_started is not None:
+            tx_latencies.append(micros - tx_started)
+            tx_started = None
+        elif event_type == TRACE_WAIT:
+            waits.append(value * 16)
+        elif event_type == TRACE_THROTTLE:
+            throttles += 1
+        elif event_type == TRACE_SPI and value in (0xE1, 0xE2):
+            flushes += 1
+
+    print_histogram("Packet loaded to TX_DS or MAX_RT seen", tx_latencies)
+    print_histogram("Waits", waits)
+    print()
+    print("FIFO flushes %d, hasData throttles %d" % (flushes, throttles))
+
+
+def main():
+    if len(sys.argv) > 1:
+        with open(sys.argv[1]) as file:
+            traces = read_events(file)
+    else:
+        traces = read_events(sys.stdin)
+
+    for number, events in enumerate(traces, 1):
+        if not events:
+            continue
+        print("Trace %d, %d events" % (number, len(events)))
+        print_timeline(events)
+        print_latencies(events)
+        print()
+
+
+if __name__ == "__main__":
+    main()